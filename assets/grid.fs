@@ -0,0 +1,37 @@
+#version 330 core
+
+in vec2 local;
+flat in vec2 size;
+flat in vec4 thumb;
+flat in vec4 region;
+flat in vec4 transform;
+flat in float layer;
+flat in float selected;
+out vec4 color;
+
+uniform sampler2DArray atlas;
+uniform vec4 background;
+uniform vec4 placeholder_color;
+uniform vec4 select_color;
+uniform float border;
+
+void main()
+{
+    color = background;
+
+    vec2 t = (local - thumb.xy) / thumb.zw;
+    if (all(greaterThanEqual(t, vec2(0.0))) && all(lessThanEqual(t, vec2(1.0)))) {
+        if (layer < 0.0) {
+            color = placeholder_color;
+        } else {
+            vec2 s = mat2(transform.xy, transform.zw) * (t - 0.5) + 0.5;
+            vec4 pixel = texture(atlas, vec3(mix(region.xy, region.zw, s), layer));
+            color.rgb = mix(background.rgb, pixel.rgb, pixel.a);
+        }
+    }
+
+    vec2 edge = min(local, 1.0 - local) * size;
+    if (selected > 0.0 && min(edge.x, edge.y) < border) {
+        color = select_color;
+    }
+}
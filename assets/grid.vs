@@ -0,0 +1,33 @@
+#version 330 core
+
+layout (location = 0) in vec4 cell;
+layout (location = 1) in vec4 image;
+layout (location = 2) in vec4 atlas;
+layout (location = 3) in vec4 orientation;
+layout (location = 4) in vec2 flags;
+
+out vec2 local;
+flat out vec2 size;
+flat out vec4 thumb;
+flat out vec4 region;
+flat out vec4 transform;
+flat out float layer;
+flat out float selected;
+
+uniform vec2 screen;
+
+void main()
+{
+    // Every instance is a cell drawn as a strip of four vertices, without any vertex buffer
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 position = (cell.xy + corner * cell.zw) / screen * 2.0 - 1.0;
+    gl_Position = vec4(position.x, -position.y, 0.0, 1.0);
+
+    local = corner;
+    size = cell.zw;
+    thumb = image;
+    region = atlas;
+    transform = orientation;
+    layer = flags.x;
+    selected = flags.y;
+}
@@ -1,11 +1,54 @@
 #version 330 core
 
 in vec2 texcoord;
+in vec2 imagecoord;
 out vec4 color;
 
 uniform sampler2D image;
+uniform vec4 background;
+
+uniform vec2 mouse;
+uniform float aspect;
+
+uniform float lens_size;
+uniform vec4 lens_color;
+
+uniform bool select_began;
+uniform vec2 select_mouse;
+uniform vec2 select_start;
+uniform vec4 select_color;
 
 void main()
 {
-    color = texture(image, texcoord);
+    // Sampled outside of any branch, so the derivatives used for mipmapping stay well defined
+    vec4 pixel = texture(image, imagecoord);
+    vec2 inside = step(vec2(0.0), imagecoord) * step(imagecoord, vec2(1.0));
+    color = vec4(mix(background.rgb, pixel.rgb, pixel.a * inside.x * inside.y), 1.0);
+
+    if (lens_color.a > 0.0 && length((mouse - texcoord) * vec2(aspect, 1.0)) >= lens_size) {
+        color.rgb = mix(color.rgb, lens_color.rgb, lens_color.a);
+    }
+
+    if (select_began) {
+        vec2 a = vec2(
+            min(select_mouse.x, select_start.x),
+            min(select_mouse.y, select_start.y));
+
+        vec2 b = vec2(
+            max(select_mouse.x, select_start.x),
+            max(select_mouse.y, select_start.y));
+
+        if (a.x <= texcoord.x && texcoord.x <= b.x) {
+            if (abs(texcoord.y - a.y) < 0.001 || abs(texcoord.y - b.y) < 0.001) {
+                color = select_color;
+            }
+        }
+
+        if (a.y <= texcoord.y && texcoord.y <= b.y) {
+            if (aspect * abs(texcoord.x - a.x) < 0.001 ||
+                aspect * abs(texcoord.x - b.x) < 0.001) {
+                color = select_color;
+            }
+        }
+    }
 }
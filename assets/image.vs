@@ -4,12 +4,19 @@ layout (location = 0) in vec2 pos;
 layout (location = 1) in vec2 uv;
 
 out vec2 texcoord;
+out vec2 imagecoord;
 
+uniform vec2 fit;
+uniform mat2 orientation;
 uniform float zoom;
 uniform vec2 offset;
 
 void main()
 {
-    gl_Position = vec4(pos * zoom + offset, 0.0, 1.0);
+    gl_Position = vec4(pos, 0.0, 1.0);
     texcoord = uv;
+
+    // The inverse of placing the image quad on the screen, so the whole frame is a single pass
+    vec2 local = (pos - offset) / (fit * zoom);
+    imagecoord = orientation * vec2(local.x, -local.y) * 0.5 + 0.5;
 }
@@ -1,12 +0,0 @@
-#version 330 core
-
-layout (location = 0) in vec2 pos;
-layout (location = 1) in vec2 uv;
-
-out vec2 texcoord;
-
-void main()
-{
-    gl_Position = vec4(pos, 0.0, 1.0);
-    texcoord = uv;
-}
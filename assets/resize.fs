@@ -0,0 +1,31 @@
+#version 330 core
+
+out vec4 color;
+
+uniform sampler2D image;
+uniform ivec2 axis;   // The axis resized by this pass, the other one is copied as is
+uniform ivec4 region; // The rectangle of the image being resized
+uniform float scale;  // Texels of the image per pixel of the target along the axis
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    ivec2 across = region.xy + pixel * (ivec2(1) - axis);
+
+    // A tent filter as wide as the footprint of the pixel averages every texel under it when
+    // shrinking, and interpolates linearly between the nearest ones when enlarging
+    float center = (float(pixel[axis.y]) + 0.5) * scale;
+    float radius = max(scale, 1.0);
+    int first = int(floor(center - radius));
+    int last = int(ceil(center + radius));
+    int size = region[2 + axis.y];
+
+    vec4 sum = vec4(0.0);
+    float total = 0.0;
+    for (int i = first; i <= last; i++) {
+        float weight = max(1.0 - abs(float(i) + 0.5 - center) / radius, 0.0);
+        sum += weight * texelFetch(image, across + axis * clamp(i, 0, size - 1), 0);
+        total += weight;
+    }
+    color = sum / total;
+}
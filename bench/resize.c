@@ -0,0 +1,106 @@
+// Times resize() on an 8K to 4K downscale, the size of a wallpaper on a 4K monitor, with a growing
+// number of threads. Built by `./nob bench` and run as
+//
+//     ./build/bench_resize [threads]
+//
+// which goes up to the given number of threads, or to one per online CPU by default
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/resize.h"
+
+#define BENCH_INPUT_WIDTH   7680
+#define BENCH_INPUT_HEIGHT  4320
+#define BENCH_OUTPUT_WIDTH  3840
+#define BENCH_OUTPUT_HEIGHT 2160
+#define BENCH_RUNS          5
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// The fastest of a few runs, so a single hiccup of the machine does not skew the result
+static double bench_resize(size_t threads, const ResizeImage *in, const ResizeImage *out) {
+    Pool pool;
+    pool_init(&pool, threads);
+
+    double best = 0;
+    for (size_t i = 0; i < BENCH_RUNS; i++) {
+        const double start = bench_now();
+        if (!resize(threads > 1 ? &pool : NULL, in, out)) {
+            fprintf(stderr, "ERROR: Failed to resize with %zu threads\n", threads);
+            exit(1);
+        }
+
+        const double elapsed = bench_now() - start;
+        if (!i || elapsed < best) best = elapsed;
+    }
+
+    pool_free(&pool);
+    return best;
+}
+
+int main(int argc, char **argv) {
+    long max = sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 1) max = strtol(argv[1], NULL, 10);
+    if (max < 1) {
+        fprintf(stderr, "ERROR: Invalid thread count '%s'\n", argv[1]);
+        return 1;
+    }
+
+    const size_t input_size = (size_t) BENCH_INPUT_WIDTH * BENCH_INPUT_HEIGHT * 4;
+    const size_t output_size = (size_t) BENCH_OUTPUT_WIDTH * BENCH_OUTPUT_HEIGHT * 4;
+    uint8_t     *input = malloc(input_size);
+    uint8_t     *output = malloc(output_size);
+    uint8_t     *expected = malloc(output_size);
+    if (!input || !output || !expected) {
+        fprintf(stderr, "ERROR: Could not allocate images\n");
+        return 1;
+    }
+
+    // Noise rather than a flat color, so nothing about the pixels makes the filter cheaper
+    srand(42);
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = rand();
+    }
+
+    const ResizeImage in = {input, BENCH_INPUT_WIDTH, BENCH_INPUT_HEIGHT, 0, STBIR_RGBA};
+    const ResizeImage out = {output, BENCH_OUTPUT_WIDTH, BENCH_OUTPUT_HEIGHT, 0, STBIR_RGBA};
+
+    printf(
+        "%dx%d to %dx%d RGBA, best of %d runs, online CPUs: %ld\n",
+        BENCH_INPUT_WIDTH,
+        BENCH_INPUT_HEIGHT,
+        BENCH_OUTPUT_WIDTH,
+        BENCH_OUTPUT_HEIGHT,
+        BENCH_RUNS,
+        sysconf(_SC_NPROCESSORS_ONLN));
+
+    // Doubles the threads every time, ending on the maximum even if it is not a power of two
+    double single = 0;
+    for (long threads = 1;; threads *= 2) {
+        if (threads > max) threads = max;
+
+        const double elapsed = bench_resize(threads, &in, &out);
+        if (threads == 1) {
+            single = elapsed;
+            memcpy(expected, output, output_size);
+        } else if (memcmp(expected, output, output_size)) {
+            fprintf(stderr, "ERROR: Output with %ld threads differs from one thread\n", threads);
+            return 1;
+        }
+
+        printf("%3ld threads: %7.1f ms, %.2fx\n", threads, elapsed * 1000, single / elapsed);
+        if (threads == max) break;
+    }
+
+    free(input);
+    free(output);
+    free(expected);
+    return 0;
+}
@@ -0,0 +1,413 @@
+const char grid_fs[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x20, 0x33, 0x33, 0x30, 0x20,
+    0x63, 0x6F, 0x72, 0x65, 0x0A, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32,
+    0x20, 0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20,
+    0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x73, 0x69, 0x7A, 0x65, 0x3B,
+    0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x34,
+    0x20, 0x74, 0x68, 0x75, 0x6D, 0x62, 0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20,
+    0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x72, 0x65, 0x67, 0x69, 0x6F,
+    0x6E, 0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20, 0x69, 0x6E, 0x20, 0x76, 0x65,
+    0x63, 0x34, 0x20, 0x74, 0x72, 0x61, 0x6E, 0x73, 0x66, 0x6F, 0x72, 0x6D, 0x3B,
+    0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20, 0x69, 0x6E, 0x20, 0x66, 0x6C, 0x6F, 0x61,
+    0x74, 0x20, 0x6C, 0x61, 0x79, 0x65, 0x72, 0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74,
+    0x20, 0x69, 0x6E, 0x20, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20, 0x73, 0x65, 0x6C,
+    0x65, 0x63, 0x74, 0x65, 0x64, 0x3B, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65,
+    0x63, 0x34, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x0A, 0x75, 0x6E,
+    0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72,
+    0x32, 0x44, 0x41, 0x72, 0x72, 0x61, 0x79, 0x20, 0x61, 0x74, 0x6C, 0x61, 0x73,
+    0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63,
+    0x34, 0x20, 0x62, 0x61, 0x63, 0x6B, 0x67, 0x72, 0x6F, 0x75, 0x6E, 0x64, 0x3B,
+    0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x34,
+    0x20, 0x70, 0x6C, 0x61, 0x63, 0x65, 0x68, 0x6F, 0x6C, 0x64, 0x65, 0x72, 0x5F,
+    0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72,
+    0x6D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74,
+    0x5F, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20, 0x62, 0x6F, 0x72, 0x64,
+    0x65, 0x72, 0x3B, 0x0A, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69,
+    0x6E, 0x28, 0x29, 0x0A, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C,
+    0x6F, 0x72, 0x20, 0x3D, 0x20, 0x62, 0x61, 0x63, 0x6B, 0x67, 0x72, 0x6F, 0x75,
+    0x6E, 0x64, 0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32,
+    0x20, 0x74, 0x20, 0x3D, 0x20, 0x28, 0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x20, 0x2D,
+    0x20, 0x74, 0x68, 0x75, 0x6D, 0x62, 0x2E, 0x78, 0x79, 0x29, 0x20, 0x2F, 0x20,
+    0x74, 0x68, 0x75, 0x6D, 0x62, 0x2E, 0x7A, 0x77, 0x3B, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x69, 0x66, 0x20, 0x28, 0x61, 0x6C, 0x6C, 0x28, 0x67, 0x72, 0x65, 0x61,
+    0x74, 0x65, 0x72, 0x54, 0x68, 0x61, 0x6E, 0x45, 0x71, 0x75, 0x61, 0x6C, 0x28,
+    0x74, 0x2C, 0x20, 0x76, 0x65, 0x63, 0x32, 0x28, 0x30, 0x2E, 0x30, 0x29, 0x29,
+    0x29, 0x20, 0x26, 0x26, 0x20, 0x61, 0x6C, 0x6C, 0x28, 0x6C, 0x65, 0x73, 0x73,
+    0x54, 0x68, 0x61, 0x6E, 0x45, 0x71, 0x75, 0x61, 0x6C, 0x28, 0x74, 0x2C, 0x20,
+    0x76, 0x65, 0x63, 0x32, 0x28, 0x31, 0x2E, 0x30, 0x29, 0x29, 0x29, 0x29, 0x20,
+    0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20,
+    0x28, 0x6C, 0x61, 0x79, 0x65, 0x72, 0x20, 0x3C, 0x20, 0x30, 0x2E, 0x30, 0x29,
+    0x20, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x70, 0x6C, 0x61,
+    0x63, 0x65, 0x68, 0x6F, 0x6C, 0x64, 0x65, 0x72, 0x5F, 0x63, 0x6F, 0x6C, 0x6F,
+    0x72, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x7D, 0x20,
+    0x65, 0x6C, 0x73, 0x65, 0x20, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x73, 0x20,
+    0x3D, 0x20, 0x6D, 0x61, 0x74, 0x32, 0x28, 0x74, 0x72, 0x61, 0x6E, 0x73, 0x66,
+    0x6F, 0x72, 0x6D, 0x2E, 0x78, 0x79, 0x2C, 0x20, 0x74, 0x72, 0x61, 0x6E, 0x73,
+    0x66, 0x6F, 0x72, 0x6D, 0x2E, 0x7A, 0x77, 0x29, 0x20, 0x2A, 0x20, 0x28, 0x74,
+    0x20, 0x2D, 0x20, 0x30, 0x2E, 0x35, 0x29, 0x20, 0x2B, 0x20, 0x30, 0x2E, 0x35,
+    0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x20, 0x3D,
+    0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 0x61, 0x74, 0x6C, 0x61,
+    0x73, 0x2C, 0x20, 0x76, 0x65, 0x63, 0x33, 0x28, 0x6D, 0x69, 0x78, 0x28, 0x72,
+    0x65, 0x67, 0x69, 0x6F, 0x6E, 0x2E, 0x78, 0x79, 0x2C, 0x20, 0x72, 0x65, 0x67,
+    0x69, 0x6F, 0x6E, 0x2E, 0x7A, 0x77, 0x2C, 0x20, 0x73, 0x29, 0x2C, 0x20, 0x6C,
+    0x61, 0x79, 0x65, 0x72, 0x29, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x2E,
+    0x72, 0x67, 0x62, 0x20, 0x3D, 0x20, 0x6D, 0x69, 0x78, 0x28, 0x62, 0x61, 0x63,
+    0x6B, 0x67, 0x72, 0x6F, 0x75, 0x6E, 0x64, 0x2E, 0x72, 0x67, 0x62, 0x2C, 0x20,
+    0x70, 0x69, 0x78, 0x65, 0x6C, 0x2E, 0x72, 0x67, 0x62, 0x2C, 0x20, 0x70, 0x69,
+    0x78, 0x65, 0x6C, 0x2E, 0x61, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x7D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x7D, 0x0A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x65, 0x64, 0x67, 0x65, 0x20,
+    0x3D, 0x20, 0x6D, 0x69, 0x6E, 0x28, 0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x2C, 0x20,
+    0x31, 0x2E, 0x30, 0x20, 0x2D, 0x20, 0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x29, 0x20,
+    0x2A, 0x20, 0x73, 0x69, 0x7A, 0x65, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69,
+    0x66, 0x20, 0x28, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x65, 0x64, 0x20, 0x3E,
+    0x20, 0x30, 0x2E, 0x30, 0x20, 0x26, 0x26, 0x20, 0x6D, 0x69, 0x6E, 0x28, 0x65,
+    0x64, 0x67, 0x65, 0x2E, 0x78, 0x2C, 0x20, 0x65, 0x64, 0x67, 0x65, 0x2E, 0x79,
+    0x29, 0x20, 0x3C, 0x20, 0x62, 0x6F, 0x72, 0x64, 0x65, 0x72, 0x29, 0x20, 0x7B,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F,
+    0x72, 0x20, 0x3D, 0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x63, 0x6F,
+    0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x7D, 0x0A, 0x7D, 0x0A,
+    0x00, 0x00,
+};
+const char grid_vs[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x20, 0x33, 0x33, 0x30, 0x20,
+    0x63, 0x6F, 0x72, 0x65, 0x0A, 0x0A, 0x6C, 0x61, 0x79, 0x6F, 0x75, 0x74, 0x20,
+    0x28, 0x6C, 0x6F, 0x63, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x30,
+    0x29, 0x20, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x63, 0x65, 0x6C,
+    0x6C, 0x3B, 0x0A, 0x6C, 0x61, 0x79, 0x6F, 0x75, 0x74, 0x20, 0x28, 0x6C, 0x6F,
+    0x63, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x31, 0x29, 0x20, 0x69,
+    0x6E, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x3B,
+    0x0A, 0x6C, 0x61, 0x79, 0x6F, 0x75, 0x74, 0x20, 0x28, 0x6C, 0x6F, 0x63, 0x61,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x32, 0x29, 0x20, 0x69, 0x6E, 0x20,
+    0x76, 0x65, 0x63, 0x34, 0x20, 0x61, 0x74, 0x6C, 0x61, 0x73, 0x3B, 0x0A, 0x6C,
+    0x61, 0x79, 0x6F, 0x75, 0x74, 0x20, 0x28, 0x6C, 0x6F, 0x63, 0x61, 0x74, 0x69,
+    0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x33, 0x29, 0x20, 0x69, 0x6E, 0x20, 0x76, 0x65,
+    0x63, 0x34, 0x20, 0x6F, 0x72, 0x69, 0x65, 0x6E, 0x74, 0x61, 0x74, 0x69, 0x6F,
+    0x6E, 0x3B, 0x0A, 0x6C, 0x61, 0x79, 0x6F, 0x75, 0x74, 0x20, 0x28, 0x6C, 0x6F,
+    0x63, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x34, 0x29, 0x20, 0x69,
+    0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x3B,
+    0x0A, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x6C, 0x6F,
+    0x63, 0x61, 0x6C, 0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20, 0x6F, 0x75, 0x74,
+    0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x73, 0x69, 0x7A, 0x65, 0x3B, 0x0A, 0x66,
+    0x6C, 0x61, 0x74, 0x20, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20,
+    0x74, 0x68, 0x75, 0x6D, 0x62, 0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20, 0x6F,
+    0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x72, 0x65, 0x67, 0x69, 0x6F,
+    0x6E, 0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20, 0x6F, 0x75, 0x74, 0x20, 0x76,
+    0x65, 0x63, 0x34, 0x20, 0x74, 0x72, 0x61, 0x6E, 0x73, 0x66, 0x6F, 0x72, 0x6D,
+    0x3B, 0x0A, 0x66, 0x6C, 0x61, 0x74, 0x20, 0x6F, 0x75, 0x74, 0x20, 0x66, 0x6C,
+    0x6F, 0x61, 0x74, 0x20, 0x6C, 0x61, 0x79, 0x65, 0x72, 0x3B, 0x0A, 0x66, 0x6C,
+    0x61, 0x74, 0x20, 0x6F, 0x75, 0x74, 0x20, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20,
+    0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x65, 0x64, 0x3B, 0x0A, 0x0A, 0x75, 0x6E,
+    0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x73, 0x63,
+    0x72, 0x65, 0x65, 0x6E, 0x3B, 0x0A, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D,
+    0x61, 0x69, 0x6E, 0x28, 0x29, 0x0A, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x2F,
+    0x2F, 0x20, 0x45, 0x76, 0x65, 0x72, 0x79, 0x20, 0x69, 0x6E, 0x73, 0x74, 0x61,
+    0x6E, 0x63, 0x65, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x63, 0x65, 0x6C, 0x6C,
+    0x20, 0x64, 0x72, 0x61, 0x77, 0x6E, 0x20, 0x61, 0x73, 0x20, 0x61, 0x20, 0x73,
+    0x74, 0x72, 0x69, 0x70, 0x20, 0x6F, 0x66, 0x20, 0x66, 0x6F, 0x75, 0x72, 0x20,
+    0x76, 0x65, 0x72, 0x74, 0x69, 0x63, 0x65, 0x73, 0x2C, 0x20, 0x77, 0x69, 0x74,
+    0x68, 0x6F, 0x75, 0x74, 0x20, 0x61, 0x6E, 0x79, 0x20, 0x76, 0x65, 0x72, 0x74,
+    0x65, 0x78, 0x20, 0x62, 0x75, 0x66, 0x66, 0x65, 0x72, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x63, 0x6F, 0x72, 0x6E, 0x65, 0x72, 0x20,
+    0x3D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x28, 0x67, 0x6C, 0x5F, 0x56, 0x65, 0x72,
+    0x74, 0x65, 0x78, 0x49, 0x44, 0x20, 0x26, 0x20, 0x31, 0x2C, 0x20, 0x67, 0x6C,
+    0x5F, 0x56, 0x65, 0x72, 0x74, 0x65, 0x78, 0x49, 0x44, 0x20, 0x3E, 0x3E, 0x20,
+    0x31, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20,
+    0x70, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x28, 0x63,
+    0x65, 0x6C, 0x6C, 0x2E, 0x78, 0x79, 0x20, 0x2B, 0x20, 0x63, 0x6F, 0x72, 0x6E,
+    0x65, 0x72, 0x20, 0x2A, 0x20, 0x63, 0x65, 0x6C, 0x6C, 0x2E, 0x7A, 0x77, 0x29,
+    0x20, 0x2F, 0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6E, 0x20, 0x2A, 0x20, 0x32,
+    0x2E, 0x30, 0x20, 0x2D, 0x20, 0x31, 0x2E, 0x30, 0x3B, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x67, 0x6C, 0x5F, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20,
+    0x3D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x70, 0x6F, 0x73, 0x69, 0x74, 0x69,
+    0x6F, 0x6E, 0x2E, 0x78, 0x2C, 0x20, 0x2D, 0x70, 0x6F, 0x73, 0x69, 0x74, 0x69,
+    0x6F, 0x6E, 0x2E, 0x79, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x31, 0x2E,
+    0x30, 0x29, 0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6C, 0x6F, 0x63, 0x61,
+    0x6C, 0x20, 0x3D, 0x20, 0x63, 0x6F, 0x72, 0x6E, 0x65, 0x72, 0x3B, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x73, 0x69, 0x7A, 0x65, 0x20, 0x3D, 0x20, 0x63, 0x65, 0x6C,
+    0x6C, 0x2E, 0x7A, 0x77, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x74, 0x68, 0x75,
+    0x6D, 0x62, 0x20, 0x3D, 0x20, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x3B, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x72, 0x65, 0x67, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x61,
+    0x74, 0x6C, 0x61, 0x73, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x74, 0x72, 0x61,
+    0x6E, 0x73, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x3D, 0x20, 0x6F, 0x72, 0x69, 0x65,
+    0x6E, 0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x6C, 0x61, 0x79, 0x65, 0x72, 0x20, 0x3D, 0x20, 0x66, 0x6C, 0x61, 0x67, 0x73,
+    0x2E, 0x78, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x73, 0x65, 0x6C, 0x65, 0x63,
+    0x74, 0x65, 0x64, 0x20, 0x3D, 0x20, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x2E, 0x79,
+    0x3B, 0x0A, 0x7D, 0x0A, 0x00, 0x20,
+};
+const char image_vs[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x20, 0x33, 0x33, 0x30, 0x20,
+    0x63, 0x6F, 0x72, 0x65, 0x0A, 0x0A, 0x6C, 0x61, 0x79, 0x6F, 0x75, 0x74, 0x20,
+    0x28, 0x6C, 0x6F, 0x63, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x30,
+    0x29, 0x20, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x70, 0x6F, 0x73,
+    0x3B, 0x0A, 0x6C, 0x61, 0x79, 0x6F, 0x75, 0x74, 0x20, 0x28, 0x6C, 0x6F, 0x63,
+    0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x31, 0x29, 0x20, 0x69, 0x6E,
+    0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x75, 0x76, 0x3B, 0x0A, 0x0A, 0x6F, 0x75,
+    0x74, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F,
+    0x72, 0x64, 0x3B, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20,
+    0x69, 0x6D, 0x61, 0x67, 0x65, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x3B, 0x0A, 0x0A,
+    0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20,
+    0x66, 0x69, 0x74, 0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20,
+    0x6D, 0x61, 0x74, 0x32, 0x20, 0x6F, 0x72, 0x69, 0x65, 0x6E, 0x74, 0x61, 0x74,
+    0x69, 0x6F, 0x6E, 0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20,
+    0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20, 0x7A, 0x6F, 0x6F, 0x6D, 0x3B, 0x0A, 0x75,
+    0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x6F,
+    0x66, 0x66, 0x73, 0x65, 0x74, 0x3B, 0x0A, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20,
+    0x6D, 0x61, 0x69, 0x6E, 0x28, 0x29, 0x0A, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x67, 0x6C, 0x5F, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D,
+    0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x70, 0x6F, 0x73, 0x2C, 0x20, 0x30, 0x2E,
+    0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x20, 0x3D, 0x20, 0x75, 0x76,
+    0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x20, 0x54, 0x68, 0x65,
+    0x20, 0x69, 0x6E, 0x76, 0x65, 0x72, 0x73, 0x65, 0x20, 0x6F, 0x66, 0x20, 0x70,
+    0x6C, 0x61, 0x63, 0x69, 0x6E, 0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x69, 0x6D,
+    0x61, 0x67, 0x65, 0x20, 0x71, 0x75, 0x61, 0x64, 0x20, 0x6F, 0x6E, 0x20, 0x74,
+    0x68, 0x65, 0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6E, 0x2C, 0x20, 0x73, 0x6F,
+    0x20, 0x74, 0x68, 0x65, 0x20, 0x77, 0x68, 0x6F, 0x6C, 0x65, 0x20, 0x66, 0x72,
+    0x61, 0x6D, 0x65, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x73, 0x69, 0x6E, 0x67,
+    0x6C, 0x65, 0x20, 0x70, 0x61, 0x73, 0x73, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x76,
+    0x65, 0x63, 0x32, 0x20, 0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x20, 0x3D, 0x20, 0x28,
+    0x70, 0x6F, 0x73, 0x20, 0x2D, 0x20, 0x6F, 0x66, 0x66, 0x73, 0x65, 0x74, 0x29,
+    0x20, 0x2F, 0x20, 0x28, 0x66, 0x69, 0x74, 0x20, 0x2A, 0x20, 0x7A, 0x6F, 0x6F,
+    0x6D, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x6D, 0x61, 0x67, 0x65,
+    0x63, 0x6F, 0x6F, 0x72, 0x64, 0x20, 0x3D, 0x20, 0x6F, 0x72, 0x69, 0x65, 0x6E,
+    0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x2A, 0x20, 0x76, 0x65, 0x63, 0x32,
+    0x28, 0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x2E, 0x78, 0x2C, 0x20, 0x2D, 0x6C, 0x6F,
+    0x63, 0x61, 0x6C, 0x2E, 0x79, 0x29, 0x20, 0x2A, 0x20, 0x30, 0x2E, 0x35, 0x20,
+    0x2B, 0x20, 0x30, 0x2E, 0x35, 0x3B, 0x0A, 0x7D, 0x0A, 0x00, 0x65,
+};
+const char resize_vs[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x20, 0x33, 0x33, 0x30, 0x20,
+    0x63, 0x6F, 0x72, 0x65, 0x0A, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61,
+    0x69, 0x6E, 0x28, 0x29, 0x0A, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x2F, 0x2F,
+    0x20, 0x41, 0x20, 0x73, 0x69, 0x6E, 0x67, 0x6C, 0x65, 0x20, 0x74, 0x72, 0x69,
+    0x61, 0x6E, 0x67, 0x6C, 0x65, 0x20, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x69, 0x6E,
+    0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x77, 0x68, 0x6F, 0x6C, 0x65, 0x20, 0x74,
+    0x61, 0x72, 0x67, 0x65, 0x74, 0x2C, 0x20, 0x77, 0x69, 0x74, 0x68, 0x6F, 0x75,
+    0x74, 0x20, 0x61, 0x6E, 0x79, 0x20, 0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x20,
+    0x62, 0x75, 0x66, 0x66, 0x65, 0x72, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65,
+    0x63, 0x32, 0x20, 0x63, 0x6F, 0x72, 0x6E, 0x65, 0x72, 0x20, 0x3D, 0x20, 0x76,
+    0x65, 0x63, 0x32, 0x28, 0x28, 0x67, 0x6C, 0x5F, 0x56, 0x65, 0x72, 0x74, 0x65,
+    0x78, 0x49, 0x44, 0x20, 0x3C, 0x3C, 0x20, 0x31, 0x29, 0x20, 0x26, 0x20, 0x32,
+    0x2C, 0x20, 0x67, 0x6C, 0x5F, 0x56, 0x65, 0x72, 0x74, 0x65, 0x78, 0x49, 0x44,
+    0x20, 0x26, 0x20, 0x32, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x67, 0x6C,
+    0x5F, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x76,
+    0x65, 0x63, 0x34, 0x28, 0x63, 0x6F, 0x72, 0x6E, 0x65, 0x72, 0x20, 0x2A, 0x20,
+    0x32, 0x2E, 0x30, 0x20, 0x2D, 0x20, 0x31, 0x2E, 0x30, 0x2C, 0x20, 0x30, 0x2E,
+    0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0A, 0x7D, 0x0A, 0x00, 0x20,
+};
+const char image_fs[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x20, 0x33, 0x33, 0x30, 0x20,
+    0x63, 0x6F, 0x72, 0x65, 0x0A, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32,
+    0x20, 0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x3B, 0x0A, 0x69, 0x6E,
+    0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x63, 0x6F,
+    0x6F, 0x72, 0x64, 0x3B, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34,
+    0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x0A, 0x75, 0x6E, 0x69, 0x66,
+    0x6F, 0x72, 0x6D, 0x20, 0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72, 0x32, 0x44,
+    0x20, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x62, 0x61, 0x63, 0x6B, 0x67,
+    0x72, 0x6F, 0x75, 0x6E, 0x64, 0x3B, 0x0A, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x6D, 0x6F, 0x75, 0x73, 0x65,
+    0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x66, 0x6C, 0x6F,
+    0x61, 0x74, 0x20, 0x61, 0x73, 0x70, 0x65, 0x63, 0x74, 0x3B, 0x0A, 0x0A, 0x75,
+    0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20,
+    0x6C, 0x65, 0x6E, 0x73, 0x5F, 0x73, 0x69, 0x7A, 0x65, 0x3B, 0x0A, 0x75, 0x6E,
+    0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x6C, 0x65,
+    0x6E, 0x73, 0x5F, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x0A, 0x75, 0x6E,
+    0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x62, 0x6F, 0x6F, 0x6C, 0x20, 0x73, 0x65,
+    0x6C, 0x65, 0x63, 0x74, 0x5F, 0x62, 0x65, 0x67, 0x61, 0x6E, 0x3B, 0x0A, 0x75,
+    0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x73,
+    0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x6D, 0x6F, 0x75, 0x73, 0x65, 0x3B, 0x0A,
+    0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20,
+    0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x73, 0x74, 0x61, 0x72, 0x74, 0x3B,
+    0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x34,
+    0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x63, 0x6F, 0x6C, 0x6F, 0x72,
+    0x3B, 0x0A, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 0x28,
+    0x29, 0x0A, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x20, 0x53, 0x61,
+    0x6D, 0x70, 0x6C, 0x65, 0x64, 0x20, 0x6F, 0x75, 0x74, 0x73, 0x69, 0x64, 0x65,
+    0x20, 0x6F, 0x66, 0x20, 0x61, 0x6E, 0x79, 0x20, 0x62, 0x72, 0x61, 0x6E, 0x63,
+    0x68, 0x2C, 0x20, 0x73, 0x6F, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x72,
+    0x69, 0x76, 0x61, 0x74, 0x69, 0x76, 0x65, 0x73, 0x20, 0x75, 0x73, 0x65, 0x64,
+    0x20, 0x66, 0x6F, 0x72, 0x20, 0x6D, 0x69, 0x70, 0x6D, 0x61, 0x70, 0x70, 0x69,
+    0x6E, 0x67, 0x20, 0x73, 0x74, 0x61, 0x79, 0x20, 0x77, 0x65, 0x6C, 0x6C, 0x20,
+    0x64, 0x65, 0x66, 0x69, 0x6E, 0x65, 0x64, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x76,
+    0x65, 0x63, 0x34, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x20, 0x3D, 0x20, 0x74,
+    0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x2C,
+    0x20, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x29, 0x3B,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x69, 0x6E, 0x73,
+    0x69, 0x64, 0x65, 0x20, 0x3D, 0x20, 0x73, 0x74, 0x65, 0x70, 0x28, 0x76, 0x65,
+    0x63, 0x32, 0x28, 0x30, 0x2E, 0x30, 0x29, 0x2C, 0x20, 0x69, 0x6D, 0x61, 0x67,
+    0x65, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x29, 0x20, 0x2A, 0x20, 0x73, 0x74, 0x65,
+    0x70, 0x28, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2C,
+    0x20, 0x76, 0x65, 0x63, 0x32, 0x28, 0x31, 0x2E, 0x30, 0x29, 0x29, 0x3B, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x76,
+    0x65, 0x63, 0x34, 0x28, 0x6D, 0x69, 0x78, 0x28, 0x62, 0x61, 0x63, 0x6B, 0x67,
+    0x72, 0x6F, 0x75, 0x6E, 0x64, 0x2E, 0x72, 0x67, 0x62, 0x2C, 0x20, 0x70, 0x69,
+    0x78, 0x65, 0x6C, 0x2E, 0x72, 0x67, 0x62, 0x2C, 0x20, 0x70, 0x69, 0x78, 0x65,
+    0x6C, 0x2E, 0x61, 0x20, 0x2A, 0x20, 0x69, 0x6E, 0x73, 0x69, 0x64, 0x65, 0x2E,
+    0x78, 0x20, 0x2A, 0x20, 0x69, 0x6E, 0x73, 0x69, 0x64, 0x65, 0x2E, 0x79, 0x29,
+    0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x69, 0x66, 0x20, 0x28, 0x6C, 0x65, 0x6E, 0x73, 0x5F, 0x63, 0x6F, 0x6C, 0x6F,
+    0x72, 0x2E, 0x61, 0x20, 0x3E, 0x20, 0x30, 0x2E, 0x30, 0x20, 0x26, 0x26, 0x20,
+    0x6C, 0x65, 0x6E, 0x67, 0x74, 0x68, 0x28, 0x28, 0x6D, 0x6F, 0x75, 0x73, 0x65,
+    0x20, 0x2D, 0x20, 0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x29, 0x20,
+    0x2A, 0x20, 0x76, 0x65, 0x63, 0x32, 0x28, 0x61, 0x73, 0x70, 0x65, 0x63, 0x74,
+    0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x29, 0x20, 0x3E, 0x3D, 0x20, 0x6C, 0x65,
+    0x6E, 0x73, 0x5F, 0x73, 0x69, 0x7A, 0x65, 0x29, 0x20, 0x7B, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x2E, 0x72,
+    0x67, 0x62, 0x20, 0x3D, 0x20, 0x6D, 0x69, 0x78, 0x28, 0x63, 0x6F, 0x6C, 0x6F,
+    0x72, 0x2E, 0x72, 0x67, 0x62, 0x2C, 0x20, 0x6C, 0x65, 0x6E, 0x73, 0x5F, 0x63,
+    0x6F, 0x6C, 0x6F, 0x72, 0x2E, 0x72, 0x67, 0x62, 0x2C, 0x20, 0x6C, 0x65, 0x6E,
+    0x73, 0x5F, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x2E, 0x61, 0x29, 0x3B, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x7D, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20,
+    0x28, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x62, 0x65, 0x67, 0x61, 0x6E,
+    0x29, 0x20, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x76,
+    0x65, 0x63, 0x32, 0x20, 0x61, 0x20, 0x3D, 0x20, 0x76, 0x65, 0x63, 0x32, 0x28,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x6D, 0x69, 0x6E, 0x28, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x6D, 0x6F,
+    0x75, 0x73, 0x65, 0x2E, 0x78, 0x2C, 0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74,
+    0x5F, 0x73, 0x74, 0x61, 0x72, 0x74, 0x2E, 0x78, 0x29, 0x2C, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x6D, 0x69, 0x6E,
+    0x28, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x6D, 0x6F, 0x75, 0x73, 0x65,
+    0x2E, 0x79, 0x2C, 0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x73, 0x74,
+    0x61, 0x72, 0x74, 0x2E, 0x79, 0x29, 0x29, 0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x62, 0x20, 0x3D,
+    0x20, 0x76, 0x65, 0x63, 0x32, 0x28, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x6D, 0x61, 0x78, 0x28, 0x73, 0x65, 0x6C,
+    0x65, 0x63, 0x74, 0x5F, 0x6D, 0x6F, 0x75, 0x73, 0x65, 0x2E, 0x78, 0x2C, 0x20,
+    0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F, 0x73, 0x74, 0x61, 0x72, 0x74, 0x2E,
+    0x78, 0x29, 0x2C, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x6D, 0x61, 0x78, 0x28, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74,
+    0x5F, 0x6D, 0x6F, 0x75, 0x73, 0x65, 0x2E, 0x79, 0x2C, 0x20, 0x73, 0x65, 0x6C,
+    0x65, 0x63, 0x74, 0x5F, 0x73, 0x74, 0x61, 0x72, 0x74, 0x2E, 0x79, 0x29, 0x29,
+    0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66,
+    0x20, 0x28, 0x61, 0x2E, 0x78, 0x20, 0x3C, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x63,
+    0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x78, 0x20, 0x26, 0x26, 0x20, 0x74, 0x65, 0x78,
+    0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x78, 0x20, 0x3C, 0x3D, 0x20, 0x62, 0x2E,
+    0x78, 0x29, 0x20, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28, 0x61, 0x62, 0x73, 0x28, 0x74,
+    0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x79, 0x20, 0x2D, 0x20, 0x61,
+    0x2E, 0x79, 0x29, 0x20, 0x3C, 0x20, 0x30, 0x2E, 0x30, 0x30, 0x31, 0x20, 0x7C,
+    0x7C, 0x20, 0x61, 0x62, 0x73, 0x28, 0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72,
+    0x64, 0x2E, 0x79, 0x20, 0x2D, 0x20, 0x62, 0x2E, 0x79, 0x29, 0x20, 0x3C, 0x20,
+    0x30, 0x2E, 0x30, 0x30, 0x31, 0x29, 0x20, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63,
+    0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74,
+    0x5F, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x7D, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x7D, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x66, 0x20, 0x28, 0x61, 0x2E, 0x79, 0x20, 0x3C, 0x3D, 0x20,
+    0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x79, 0x20, 0x26, 0x26,
+    0x20, 0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x79, 0x20, 0x3C,
+    0x3D, 0x20, 0x62, 0x2E, 0x79, 0x29, 0x20, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28, 0x61,
+    0x73, 0x70, 0x65, 0x63, 0x74, 0x20, 0x2A, 0x20, 0x61, 0x62, 0x73, 0x28, 0x74,
+    0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x78, 0x20, 0x2D, 0x20, 0x61,
+    0x2E, 0x78, 0x29, 0x20, 0x3C, 0x20, 0x30, 0x2E, 0x30, 0x30, 0x31, 0x20, 0x7C,
+    0x7C, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x61, 0x73, 0x70, 0x65, 0x63, 0x74, 0x20, 0x2A,
+    0x20, 0x61, 0x62, 0x73, 0x28, 0x74, 0x65, 0x78, 0x63, 0x6F, 0x6F, 0x72, 0x64,
+    0x2E, 0x78, 0x20, 0x2D, 0x20, 0x62, 0x2E, 0x78, 0x29, 0x20, 0x3C, 0x20, 0x30,
+    0x2E, 0x30, 0x30, 0x31, 0x29, 0x20, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F,
+    0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x5F,
+    0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x7D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x7D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x7D, 0x0A, 0x7D, 0x0A,
+    0x00, 0x00,
+};
+const char resize_fs[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x20, 0x33, 0x33, 0x30, 0x20,
+    0x63, 0x6F, 0x72, 0x65, 0x0A, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63,
+    0x34, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x0A, 0x75, 0x6E, 0x69,
+    0x66, 0x6F, 0x72, 0x6D, 0x20, 0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72, 0x32,
+    0x44, 0x20, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66,
+    0x6F, 0x72, 0x6D, 0x20, 0x69, 0x76, 0x65, 0x63, 0x32, 0x20, 0x61, 0x78, 0x69,
+    0x73, 0x3B, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x20, 0x54, 0x68, 0x65, 0x20, 0x61,
+    0x78, 0x69, 0x73, 0x20, 0x72, 0x65, 0x73, 0x69, 0x7A, 0x65, 0x64, 0x20, 0x62,
+    0x79, 0x20, 0x74, 0x68, 0x69, 0x73, 0x20, 0x70, 0x61, 0x73, 0x73, 0x2C, 0x20,
+    0x74, 0x68, 0x65, 0x20, 0x6F, 0x74, 0x68, 0x65, 0x72, 0x20, 0x6F, 0x6E, 0x65,
+    0x20, 0x69, 0x73, 0x20, 0x63, 0x6F, 0x70, 0x69, 0x65, 0x64, 0x20, 0x61, 0x73,
+    0x20, 0x69, 0x73, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x69,
+    0x76, 0x65, 0x63, 0x34, 0x20, 0x72, 0x65, 0x67, 0x69, 0x6F, 0x6E, 0x3B, 0x20,
+    0x2F, 0x2F, 0x20, 0x54, 0x68, 0x65, 0x20, 0x72, 0x65, 0x63, 0x74, 0x61, 0x6E,
+    0x67, 0x6C, 0x65, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x69, 0x6D,
+    0x61, 0x67, 0x65, 0x20, 0x62, 0x65, 0x69, 0x6E, 0x67, 0x20, 0x72, 0x65, 0x73,
+    0x69, 0x7A, 0x65, 0x64, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20,
+    0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20, 0x73, 0x63, 0x61, 0x6C, 0x65, 0x3B, 0x20,
+    0x20, 0x2F, 0x2F, 0x20, 0x54, 0x65, 0x78, 0x65, 0x6C, 0x73, 0x20, 0x6F, 0x66,
+    0x20, 0x74, 0x68, 0x65, 0x20, 0x69, 0x6D, 0x61, 0x67, 0x65, 0x20, 0x70, 0x65,
+    0x72, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68,
+    0x65, 0x20, 0x74, 0x61, 0x72, 0x67, 0x65, 0x74, 0x20, 0x61, 0x6C, 0x6F, 0x6E,
+    0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x61, 0x78, 0x69, 0x73, 0x0A, 0x0A, 0x76,
+    0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 0x28, 0x29, 0x0A, 0x7B, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x69, 0x76, 0x65, 0x63, 0x32, 0x20, 0x70, 0x69, 0x78,
+    0x65, 0x6C, 0x20, 0x3D, 0x20, 0x69, 0x76, 0x65, 0x63, 0x32, 0x28, 0x67, 0x6C,
+    0x5F, 0x46, 0x72, 0x61, 0x67, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x78, 0x79,
+    0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x76, 0x65, 0x63, 0x32, 0x20,
+    0x61, 0x63, 0x72, 0x6F, 0x73, 0x73, 0x20, 0x3D, 0x20, 0x72, 0x65, 0x67, 0x69,
+    0x6F, 0x6E, 0x2E, 0x78, 0x79, 0x20, 0x2B, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C,
+    0x20, 0x2A, 0x20, 0x28, 0x69, 0x76, 0x65, 0x63, 0x32, 0x28, 0x31, 0x29, 0x20,
+    0x2D, 0x20, 0x61, 0x78, 0x69, 0x73, 0x29, 0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x2F, 0x2F, 0x20, 0x41, 0x20, 0x74, 0x65, 0x6E, 0x74, 0x20, 0x66, 0x69,
+    0x6C, 0x74, 0x65, 0x72, 0x20, 0x61, 0x73, 0x20, 0x77, 0x69, 0x64, 0x65, 0x20,
+    0x61, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x6F, 0x6F, 0x74, 0x70, 0x72,
+    0x69, 0x6E, 0x74, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x69,
+    0x78, 0x65, 0x6C, 0x20, 0x61, 0x76, 0x65, 0x72, 0x61, 0x67, 0x65, 0x73, 0x20,
+    0x65, 0x76, 0x65, 0x72, 0x79, 0x20, 0x74, 0x65, 0x78, 0x65, 0x6C, 0x20, 0x75,
+    0x6E, 0x64, 0x65, 0x72, 0x20, 0x69, 0x74, 0x20, 0x77, 0x68, 0x65, 0x6E, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x20, 0x73, 0x68, 0x72, 0x69, 0x6E, 0x6B,
+    0x69, 0x6E, 0x67, 0x2C, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x69, 0x6E, 0x74, 0x65,
+    0x72, 0x70, 0x6F, 0x6C, 0x61, 0x74, 0x65, 0x73, 0x20, 0x6C, 0x69, 0x6E, 0x65,
+    0x61, 0x72, 0x6C, 0x79, 0x20, 0x62, 0x65, 0x74, 0x77, 0x65, 0x65, 0x6E, 0x20,
+    0x74, 0x68, 0x65, 0x20, 0x6E, 0x65, 0x61, 0x72, 0x65, 0x73, 0x74, 0x20, 0x6F,
+    0x6E, 0x65, 0x73, 0x20, 0x77, 0x68, 0x65, 0x6E, 0x20, 0x65, 0x6E, 0x6C, 0x61,
+    0x72, 0x67, 0x69, 0x6E, 0x67, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6C, 0x6F,
+    0x61, 0x74, 0x20, 0x63, 0x65, 0x6E, 0x74, 0x65, 0x72, 0x20, 0x3D, 0x20, 0x28,
+    0x66, 0x6C, 0x6F, 0x61, 0x74, 0x28, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x5B, 0x61,
+    0x78, 0x69, 0x73, 0x2E, 0x79, 0x5D, 0x29, 0x20, 0x2B, 0x20, 0x30, 0x2E, 0x35,
+    0x29, 0x20, 0x2A, 0x20, 0x73, 0x63, 0x61, 0x6C, 0x65, 0x3B, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20, 0x72, 0x61, 0x64, 0x69, 0x75,
+    0x73, 0x20, 0x3D, 0x20, 0x6D, 0x61, 0x78, 0x28, 0x73, 0x63, 0x61, 0x6C, 0x65,
+    0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69,
+    0x6E, 0x74, 0x20, 0x66, 0x69, 0x72, 0x73, 0x74, 0x20, 0x3D, 0x20, 0x69, 0x6E,
+    0x74, 0x28, 0x66, 0x6C, 0x6F, 0x6F, 0x72, 0x28, 0x63, 0x65, 0x6E, 0x74, 0x65,
+    0x72, 0x20, 0x2D, 0x20, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x29, 0x29, 0x3B,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x6E, 0x74, 0x20, 0x6C, 0x61, 0x73, 0x74,
+    0x20, 0x3D, 0x20, 0x69, 0x6E, 0x74, 0x28, 0x63, 0x65, 0x69, 0x6C, 0x28, 0x63,
+    0x65, 0x6E, 0x74, 0x65, 0x72, 0x20, 0x2B, 0x20, 0x72, 0x61, 0x64, 0x69, 0x75,
+    0x73, 0x29, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x6E, 0x74, 0x20,
+    0x73, 0x69, 0x7A, 0x65, 0x20, 0x3D, 0x20, 0x72, 0x65, 0x67, 0x69, 0x6F, 0x6E,
+    0x5B, 0x32, 0x20, 0x2B, 0x20, 0x61, 0x78, 0x69, 0x73, 0x2E, 0x79, 0x5D, 0x3B,
+    0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x73, 0x75,
+    0x6D, 0x20, 0x3D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x30, 0x2E, 0x30, 0x29,
+    0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x20, 0x74,
+    0x6F, 0x74, 0x61, 0x6C, 0x20, 0x3D, 0x20, 0x30, 0x2E, 0x30, 0x3B, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x28, 0x69, 0x6E, 0x74, 0x20, 0x69,
+    0x20, 0x3D, 0x20, 0x66, 0x69, 0x72, 0x73, 0x74, 0x3B, 0x20, 0x69, 0x20, 0x3C,
+    0x3D, 0x20, 0x6C, 0x61, 0x73, 0x74, 0x3B, 0x20, 0x69, 0x2B, 0x2B, 0x29, 0x20,
+    0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6C, 0x6F,
+    0x61, 0x74, 0x20, 0x77, 0x65, 0x69, 0x67, 0x68, 0x74, 0x20, 0x3D, 0x20, 0x6D,
+    0x61, 0x78, 0x28, 0x31, 0x2E, 0x30, 0x20, 0x2D, 0x20, 0x61, 0x62, 0x73, 0x28,
+    0x66, 0x6C, 0x6F, 0x61, 0x74, 0x28, 0x69, 0x29, 0x20, 0x2B, 0x20, 0x30, 0x2E,
+    0x35, 0x20, 0x2D, 0x20, 0x63, 0x65, 0x6E, 0x74, 0x65, 0x72, 0x29, 0x20, 0x2F,
+    0x20, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x29,
+    0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x73, 0x75, 0x6D,
+    0x20, 0x2B, 0x3D, 0x20, 0x77, 0x65, 0x69, 0x67, 0x68, 0x74, 0x20, 0x2A, 0x20,
+    0x74, 0x65, 0x78, 0x65, 0x6C, 0x46, 0x65, 0x74, 0x63, 0x68, 0x28, 0x69, 0x6D,
+    0x61, 0x67, 0x65, 0x2C, 0x20, 0x61, 0x63, 0x72, 0x6F, 0x73, 0x73, 0x20, 0x2B,
+    0x20, 0x61, 0x78, 0x69, 0x73, 0x20, 0x2A, 0x20, 0x63, 0x6C, 0x61, 0x6D, 0x70,
+    0x28, 0x69, 0x2C, 0x20, 0x30, 0x2C, 0x20, 0x73, 0x69, 0x7A, 0x65, 0x20, 0x2D,
+    0x20, 0x31, 0x29, 0x2C, 0x20, 0x30, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x74, 0x6F, 0x74, 0x61, 0x6C, 0x20, 0x2B, 0x3D, 0x20,
+    0x77, 0x65, 0x69, 0x67, 0x68, 0x74, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x7D,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20,
+    0x73, 0x75, 0x6D, 0x20, 0x2F, 0x20, 0x74, 0x6F, 0x74, 0x61, 0x6C, 0x3B, 0x0A,
+    0x7D, 0x0A, 0x00, 0x72,
+};
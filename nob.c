@@ -118,10 +118,20 @@ int main(int argc, char **argv) {
     nob_cmd_append(&cmd, "cc", "-O3", "-o", "build/thono");
     if (!push_matches_into_cmd(&cmd, "src", ".c")) return 1;
     if (!push_matches_into_cmd(&cmd, "build", ".o")) return 1;
-    nob_cmd_append(&cmd, "build/shader.c", "-lm", "-lGL", "-lX11");
+    nob_cmd_append(&cmd, "build/shader.c", "-lm", "-lGL", "-lX11", "-lXext", "-lpthread", "-ldl");
 
     if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
 
     nob_log(NOB_INFO, "Build executable `thono`");
+
+    nob_shift(argv, argc);
+    if (argc && !strcmp(argv[0], "bench")) {
+        nob_cmd_append(&cmd, "cc", "-O3", "-o", "build/bench_resize", "bench/resize.c");
+        nob_cmd_append(&cmd, "src/resize.c", "src/resize_avx2.c", "src/pool.c");
+        nob_cmd_append(&cmd, "build/stb_image_resize2.o", "-lm", "-lpthread");
+        if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+
+        nob_log(NOB_INFO, "Build executable `bench_resize`");
+    }
     return 0;
 }
@@ -1,10 +1,15 @@
+#define _GNU_SOURCE
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <libgen.h>
+#include <limits.h>
+#include <stdatomic.h>
 #include <unistd.h>
 
 #include <math.h>
+#include <poll.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/time.h>
@@ -15,7 +20,13 @@
 
 #include "app.h"
 #include "basic.h"
+#include "cache.h"
 #include "config.h"
+#include "exif.h"
+#include "gif.h"
+#include "mipmap.h"
+#include "resize.h"
+#include "shm.h"
 
 #include "stb_image.h"
 #include "stb_image_write.h"
@@ -58,12 +69,13 @@ static XImage *app_snap_ximage(App *a, Vec2 start, Vec2 size) {
     return image;
 }
 
-static Pixel *app_snap(App *a, Vec2 start, Vec2 size) {
+// The screen is opaque, so the alpha channel is only stored if asked for with 4 channels
+static uint8_t *app_snap(App *a, Vec2 start, Vec2 size, size_t channels) {
     const uint width = size.x;
     const uint height = size.y;
 
-    XImage *image = app_snap_ximage(a, start, size);
-    Pixel  *pixels = malloc(width * height * sizeof(Pixel));
+    XImage  *image = app_snap_ximage(a, start, size);
+    uint8_t *pixels = malloc(width * height * channels);
     if (!pixels) {
         fprintf(stderr, "ERROR: Could not allocate screenshot buffer\n");
         exit(1);
@@ -72,11 +84,11 @@ static Pixel *app_snap(App *a, Vec2 start, Vec2 size) {
     for (uint y = 0; y < height; ++y) {
         for (uint x = 0; x < width; ++x) {
             const ulong p = XGetPixel(image, x, y);
-            Pixel      *it = &pixels[y * width + x];
-            it->r = (p & image->red_mask) >> 16;
-            it->g = (p & image->green_mask) >> 8;
-            it->b = (p & image->blue_mask);
-            it->a = 0xFF;
+            uint8_t    *it = &pixels[(y * width + x) * channels];
+            it[0] = (p & image->red_mask) >> 16;
+            it[1] = (p & image->green_mask) >> 8;
+            it[2] = (p & image->blue_mask);
+            if (channels == 4) it[3] = 0xFF;
         }
     }
 
@@ -85,13 +97,13 @@ static Pixel *app_snap(App *a, Vec2 start, Vec2 size) {
 }
 
 static void app_save_image(App *a, Vec2 start, Vec2 size) {
-    Pixel          *image = app_snap(a, start, size);
+    uint8_t        *image = app_snap(a, start, size, 3);
     const long long since = get_time() * 1000;
 
     char buffer[64];
     snprintf(buffer, sizeof(buffer), "thono-%lld.png", since);
 
-    if (!stbi_write_png(buffer, size.x, size.y, 4, image, size.x * sizeof(*image))) {
+    if (!stbi_write_png(buffer, size.x, size.y, 3, image, size.x * 3)) {
         fprintf(stderr, "ERROR: Could not save screenshot to png\n");
         exit(1);
     }
@@ -99,89 +111,1294 @@ static void app_save_image(App *a, Vec2 start, Vec2 size) {
     free(image);
 }
 
+// The size of the image as displayed, after its orientation
+static Vec2 image_size(const Image *image) {
+    if (image->rotation % 2) {
+        return (Vec2) {image->height, image->width};
+    }
+    return (Vec2) {image->width, image->height};
+}
+
+// Column major matrix taking displayed image coordinates to stored ones around the center, which
+// undoes the rotation and then the flip
+static void image_orientation(const Image *image, float m[4]) {
+    static const float rotations[4][4] = {
+        {1, 0, 0, 1},
+        {0, -1, 1, 0},
+        {-1, 0, 0, -1},
+        {0, 1, -1, 0},
+    };
+
+    memcpy(m, rotations[image->rotation], sizeof(rotations[0]));
+    if (image->flip) {
+        m[0] = -m[0];
+        m[2] = -m[2];
+    }
+}
+
+static Vec2 app_image_fit(const App *a, const Image *image) {
+    // Images smaller than the screen are shown at their native size, larger ones are scaled down
+    const Vec2  size = image_size(image);
+    const float scale = max(1.0, max(size.x / a->size.x, size.y / a->size.y));
+    return (Vec2) {size.x / (a->size.x * scale), size.y / (a->size.y * scale)};
+}
+
+// Mirrors the shown image horizontally if asked for, then rotates it clockwise by quarter turns,
+// both relative to how it is currently displayed
+static void app_orient_image(App *a, bool flip, size_t turns) {
+    if (a->shown == SIZE_MAX) {
+        return;
+    }
+
+    Image *image = &a->images.data[a->shown];
+    if (flip) {
+        image->rotation = (4 - image->rotation) % 4;
+        image->flip = !image->flip;
+    }
+    image->rotation = (image->rotation + turns) % 4;
+}
+
+static bool image_is_file(const Image *image) {
+    return image->type == IMAGE_FILE_QUEUED || image->type == IMAGE_FILE_LOADING ||
+           image->type == IMAGE_FILE_LOADED;
+}
+
+static void image_free(Image *image) {
+    if (image->type == IMAGE_MAPPED) {
+        munmap(image->data, image->width * image->height * image->channels);
+    } else {
+        free(image->data);
+    }
+    free(image->mipmaps);
+}
+
+static void image_level(const Image *image, size_t level, size_t *w, size_t *h, const uint8_t **p) {
+    mipmap_level_size(image->width, image->height, level, w, h);
+    if (level) {
+        const size_t offset = mipmap_level_offset(image->width, image->height, level);
+        *p = image->mipmaps + offset * image->channels;
+    } else {
+        *p = image->data;
+    }
+}
+
+typedef struct {
+    char  *path; // Owned copy, as the paths buffer may move while decoding
+    size_t key;  // Offset of the path in App.paths, which identifies the image
+    bool   mipmapped;
+    bool   preview; // Only loads a quick stand-in to show upscaled, from the cache or the thumbnail
+    bool   animated;
+    int    orientation;
+
+    uint8_t *data;
+    uint8_t *mipmaps;
+    int      width;
+    int      height;
+    int      channels; // Zero keeps the channels the image was stored with
+
+    // Size of the full image, as the preview is smaller
+    int image_width;
+    int image_height;
+
+    Cache   *cache;
+    size_t   screen_width; // Images are cached scaled down to fit the screen
+    size_t   screen_height;
+    uint64_t store_key; // Of the cache entry still to be written once the image is shown
+    bool     store;
+} Decode;
+
+static const stbir_pixel_layout pixel_layouts[] = {
+    [1] = STBIR_1CHANNEL,
+    [2] = STBIR_RA,
+    [3] = STBIR_RGB,
+    [4] = STBIR_RGBA,
+};
+
+// Stores the image scaled down to fit the screen, the way it is displayed
+static void decode_store_cache(const Decode *d, uint64_t key) {
+    // The EXIF orientations past 4 swap the axes
+    const bool   swap = d->orientation > 4;
+    const double sw = swap ? d->screen_height : d->screen_width;
+    const double sh = swap ? d->screen_width : d->screen_height;
+    const double scale = max(1.0, max(d->width / sw, d->height / sh));
+
+    CacheEntry e = {
+        .data = d->data,
+        .width = max(d->width / scale, 1),
+        .height = max(d->height / scale, 1),
+        .channels = d->channels,
+        .image_width = d->width,
+        .image_height = d->height,
+        .orientation = d->orientation,
+    };
+
+    if (e.width != (size_t) d->width || e.height != (size_t) d->height) {
+        // Decodes already run in parallel, so each resize stays on its own thread
+        e.data = resize_alloc(
+            NULL, d->data, d->width, d->height, e.width, e.height, pixel_layouts[d->channels]);
+        if (!e.data) return;
+    }
+
+    cache_store(d->cache, key, &e);
+    if (e.data != d->data) free(e.data);
+}
+
+static bool decode_load_cache(Decode *d, uint64_t key) {
+    CacheEntry e;
+    if (!cache_load(d->cache, key, &e)) {
+        return false;
+    }
+
+    d->data = e.data;
+    d->width = e.width;
+    d->height = e.height;
+    d->channels = e.channels;
+    d->image_width = e.image_width;
+    d->image_height = e.image_height;
+    d->orientation = e.orientation >= 1 && e.orientation <= 8 ? e.orientation : 1;
+    return true;
+}
+
+// Maps a whole file for reading, so the metadata and the pixels are read from the same mapping.
+// Returns NULL if it could not be mapped, or is too large for stb_image
+static uint8_t *map_file(const char *path, struct stat *statbuf) {
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    uint8_t *file = MAP_FAILED;
+    if (fstat(fd, statbuf) == 0 && statbuf->st_size > 0 && statbuf->st_size <= INT_MAX) {
+        file = mmap(NULL, statbuf->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    close(fd);
+    return file == MAP_FAILED ? NULL : file;
+}
+
+static void decode_run(void *data) {
+    Decode *d = data;
+
+    struct stat statbuf = {0};
+    uint8_t    *file = map_file(d->path, &statbuf);
+    if (!file) {
+        return;
+    }
+
+    const size_t   size = statbuf.st_size;
+    const uint64_t key =
+        cache_key(d->path, &statbuf, d->screen_width, d->screen_height, d->channels);
+    if (d->preview && decode_load_cache(d, key)) {
+        munmap(file, size);
+        return;
+    }
+
+    const Exif exif = exif_parse(file, size);
+    d->orientation = exif.orientation;
+
+    int channels = 0;
+    if (!d->preview) {
+        // Only the first frame is decoded here, the rest are streamed while it is shown
+        d->animated = gif_is_animated(file, size);
+        d->data = stbi_load_from_memory(file, size, &d->width, &d->height, &channels, d->channels);
+    } else if (exif.thumbnail) {
+        // Only the headers of the full image are read, which is enough to get its size
+        if (stbi_info_from_memory(file, size, &d->image_width, &d->image_height, &channels)) {
+            d->data = stbi_load_from_memory(
+                exif.thumbnail, exif.thumbnail_size, &d->width, &d->height, &channels, d->channels);
+        }
+    }
+    if (!d->channels) d->channels = channels;
+    munmap(file, size);
+
+    // Writing the entry is left for after the image is shown
+    if (d->data && !d->preview && !cache_exists(d->cache, key)) {
+        d->store = true;
+        d->store_key = key;
+    }
+
+    // Building the chain here keeps the driver from generating it on the render thread
+    if (d->data && d->mipmapped) {
+        d->mipmaps = mipmap_build(d->data, d->width, d->height, d->channels);
+    }
+}
+
+static void decode_free(void *data) {
+    Decode *d = data;
+    stbi_image_free(d->data);
+    free(d->mipmaps);
+    free(d->path);
+    free(d);
+}
+
+// Writes the cache entry of an image which is already shown. The pixels are not owned, as loaded
+// images outlive the cache worker
+static void store_run(void *data) {
+    const Decode *d = data;
+    decode_store_cache(d, d->store_key);
+}
+
+typedef struct {
+    const GridRange *range;
+    size_t           index;
+    size_t           generation;
+
+    char          *path;   // Owned copy, NULL if the pixels of the image are already in memory
+    const uint8_t *source; // Not owned, as loaded images outlive the grid worker
+    int            source_width;
+    int            source_height;
+    int            source_channels;
+
+    Cache *cache;
+    size_t screen_width;
+    size_t screen_height;
+
+    uint8_t *data; // Packed RGBA fitted into GRID_THUMB_SIZE
+    int      width;
+    int      height;
+    int      orientation;
+    bool     skipped; // Scrolled out of range before it got to run
+} ThumbJob;
+
+// Loads the cheapest pixels which are good enough for a thumbnail: the screen sized copy in the
+// cache, the thumbnail embedded in the EXIF metadata, and only then the full image, which gets
+// cached for the next time
+static uint8_t *thumb_load(ThumbJob *t, int *width, int *height, int *channels) {
+    struct stat statbuf = {0};
+    uint8_t    *file = map_file(t->path, &statbuf);
+    if (!file) {
+        return NULL;
+    }
+
+    Decode d = {
+        .orientation = 1,
+        .cache = t->cache,
+        .screen_width = t->screen_width,
+        .screen_height = t->screen_height,
+    };
+
+    const uint64_t key = cache_key(t->path, &statbuf, t->screen_width, t->screen_height, 0);
+    if (!decode_load_cache(&d, key)) {
+        const Exif exif = exif_parse(file, statbuf.st_size);
+        d.orientation = exif.orientation;
+
+        if (exif.thumbnail) {
+            d.data = stbi_load_from_memory(
+                exif.thumbnail, exif.thumbnail_size, &d.width, &d.height, &d.channels, 0);
+        }
+
+        if (!d.data) {
+            d.data = stbi_load_from_memory(
+                file, statbuf.st_size, &d.width, &d.height, &d.channels, 0);
+            if (d.data && !cache_exists(t->cache, key)) decode_store_cache(&d, key);
+        }
+    }
+    munmap(file, statbuf.st_size);
+
+    t->orientation = d.orientation;
+    *width = d.width;
+    *height = d.height;
+    *channels = d.channels;
+    return d.data;
+}
+
+// Scales the pixels down to fit GRID_THUMB_SIZE and expands them to RGBA, the format of the atlas
+static void thumb_fit(ThumbJob *t, const uint8_t *pixels, int width, int height, int channels) {
+    const double scale = max(1.0, max(width, height) / (double) GRID_THUMB_SIZE);
+    t->width = max(width / scale, 1);
+    t->height = max(height / scale, 1);
+
+    uint8_t *resized = NULL;
+    if (t->width != width || t->height != height) {
+        resized = resize_alloc(
+            NULL, pixels, width, height, t->width, t->height, pixel_layouts[channels]);
+        if (!resized) return;
+        pixels = resized;
+    }
+
+    const size_t count = (size_t) t->width * t->height;
+    t->data = malloc(count * 4);
+    if (t->data) {
+        for (size_t i = 0; i < count; i++) {
+            const uint8_t *p = pixels + i * channels;
+            uint8_t       *q = t->data + i * 4;
+            q[0] = p[0];
+            q[1] = channels >= 3 ? p[1] : p[0];
+            q[2] = channels >= 3 ? p[2] : p[0];
+            q[3] = channels == 2 ? p[1] : channels == 4 ? p[3] : 0xFF;
+        }
+    }
+    free(resized);
+}
+
+static void thumb_run(void *data) {
+    ThumbJob *t = data;
+
+    // Jobs run in the order they were requested, so the ones left behind by scrolling are dropped
+    // quickly to get to the visible ones
+    if (t->generation != atomic_load(&t->range->generation) ||
+        t->index < atomic_load(&t->range->first) || t->index >= atomic_load(&t->range->last)) {
+        t->skipped = true;
+        return;
+    }
+
+    if (t->source) {
+        thumb_fit(t, t->source, t->source_width, t->source_height, t->source_channels);
+        return;
+    }
+
+    int      width, height, channels;
+    uint8_t *pixels = thumb_load(t, &width, &height, &channels);
+    if (pixels) {
+        thumb_fit(t, pixels, width, height, channels);
+        stbi_image_free(pixels);
+    }
+}
+
+static void thumb_free(void *data) {
+    ThumbJob *t = data;
+    free(t->data);
+    free(t->path);
+    free(t);
+}
+
+static size_t image_texture_size(const Image *image) {
+    // The mipmap chain adds another third on top of the base level
+    return image->width * image->height * image->channels * 4 / 3;
+}
+
+static void app_drop_texture(App *a, Image *image) {
+    glDeleteTextures(1, &image->texture);
+    image->texture = 0;
+
+    a->texture_count--;
+    a->texture_bytes -= image_texture_size(image);
+}
+
+// Evicts the least recently shown textures until another one of the given size fits the cache
+static void app_evict_textures(App *a, size_t size) {
+    while (a->texture_count >= TEXTURE_CACHE_COUNT ||
+           (a->texture_count && a->texture_bytes + size > TEXTURE_CACHE_BUDGET)) {
+        Image *lru = NULL;
+        for (size_t i = 0; i < a->images.count; i++) {
+            Image *image = &a->images.data[i];
+            if (image->texture && i != a->shown) {
+                if (!lru || image->texture_used < lru->texture_used) lru = image;
+            }
+        }
+
+        if (!lru) break;
+        app_drop_texture(a, lru);
+    }
+}
+
+static void app_remove_image(App *a, size_t index) {
+    // Thumbnails refer to their images by index, so the ones still being made are stale now
+    const Thumb *thumb = &a->images.data[index].thumb;
+    if (thumb->state == THUMB_READY) a->grid_owners[thumb->slot] = SIZE_MAX;
+    for (size_t i = 0; i < a->grid_slots; i++) {
+        if (a->grid_owners[i] != SIZE_MAX && a->grid_owners[i] > index) a->grid_owners[i]--;
+    }
+    for (size_t i = 0; i < a->images.count; i++) {
+        if (a->images.data[i].thumb.state == THUMB_PENDING) {
+            a->images.data[i].thumb.state = THUMB_NONE;
+        }
+    }
+    atomic_fetch_add(&a->grid_range.generation, 1);
+    if (a->grid_selected && a->grid_selected >= index) a->grid_selected--;
+
+    if (a->images.data[index].texture) app_drop_texture(a, &a->images.data[index]);
+    image_free(&a->images.data[index]);
+    da_remove(&a->images, index);
+
+    if (a->shown == index) {
+        a->shown = SIZE_MAX;
+        a->preview_shown = false;
+    } else if (a->shown != SIZE_MAX && a->shown > index) {
+        a->shown--;
+    }
+
+    if (a->upload_image == index) {
+        a->upload_image = SIZE_MAX;
+    } else if (a->upload_image != SIZE_MAX && a->upload_image > index) {
+        a->upload_image--;
+    }
+}
+
+static void app_show_image(App *a, size_t index) {
+    // The full image replacing its preview keeps the view as is
+    if (!a->preview_shown || a->shown != index) {
+        a->final.zoom = 1.0;
+        a->final.offset = vec2_scale(a->size, 0.5);
+    }
+
+    a->shown = index;
+    a->preview_shown = false;
+    a->images.data[index].texture_used = ++a->texture_tick;
+}
+
+typedef struct {
+    GLenum internal;
+    GLenum format;
+    GLint  swizzle[4];
+} TextureFormat;
+
+// Images keep the channels they were stored with, and the swizzle expands them back to RGBA when
+// sampled, so the shaders only ever see RGBA
+static const TextureFormat texture_formats[] = {
+    [1] = {GL_R8, GL_RED, {GL_RED, GL_RED, GL_RED, GL_ONE}},
+    [2] = {GL_RG8, GL_RG, {GL_RED, GL_RED, GL_RED, GL_GREEN}},
+    [3] = {GL_RGB8, GL_RGB, {GL_RED, GL_GREEN, GL_BLUE, GL_ONE}},
+    [4] = {GL_RGBA8, GL_RGBA, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}},
+};
+
+// Starts uploading an image into a spare texture. The shown image stays on screen until the
+// upload is complete, which is spread across frames by app_upload_step()
+static void app_upload_image(App *a, size_t index) {
+    const Image *image = &a->images.data[index];
+
+    a->upload_image = index;
+    a->upload_level = 0;
+    a->upload_row = 0;
+    app_evict_textures(a, image_texture_size(image));
+
+    // Immutable storage cannot be respecified, so an upload that was abandoned halfway is dropped
+    if (a->upload_texture) {
+        glDeleteTextures(1, &a->upload_texture);
+    }
+
+    glGenTextures(1, &a->upload_texture);
+    glBindTexture(GL_TEXTURE_2D, a->upload_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    const TextureFormat *format = &texture_formats[image->channels];
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, format->swizzle);
+
+    const size_t levels = mipmap_levels(image->width, image->height);
+    if (a->texture_storage) {
+        glTexStorage2D(GL_TEXTURE_2D, levels, format->internal, image->width, image->height);
+    } else {
+        for (size_t level = 0; level < levels; level++) {
+            size_t w, h;
+            mipmap_level_size(image->width, image->height, level, &w, &h);
+            glTexImage2D(
+                GL_TEXTURE_2D,
+                level,
+                format->internal,
+                w,
+                h,
+                0,
+                format->format,
+                GL_UNSIGNED_BYTE,
+                NULL);
+        }
+    }
+}
+
+// Uploads the next slice of rows, going through the levels of the mipmap chain in order. Returns
+// true while the upload is still in progress
+static bool app_upload_step(App *a) {
+    if (a->upload_image == SIZE_MAX) {
+        return false;
+    }
+
+    const Image *image = &a->images.data[a->upload_image];
+
+    size_t         width, height;
+    const uint8_t *level;
+    image_level(image, a->upload_level, &width, &height, &level);
+
+    const TextureFormat *format = &texture_formats[image->channels];
+    const size_t         stride = width * image->channels;
+    const uint8_t       *pixels = level + a->upload_row * stride;
+
+    const size_t rows = min(height - a->upload_row, max(UPLOAD_SLICE_SIZE / stride, 1));
+
+    glBindTexture(GL_TEXTURE_2D, a->upload_texture);
+    if (a->upload_map && stride <= UPLOAD_SLICE_SIZE) {
+        // Slices of the persistently mapped buffer are only reused once the GPU is done with them
+        GLsync *fence = &a->upload_fences[a->upload_slice];
+        if (*fence) {
+            if (glClientWaitSync(*fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                return true;
+            }
+            glDeleteSync(*fence);
+        }
+
+        const size_t offset = a->upload_slice * UPLOAD_SLICE_SIZE;
+        memcpy(a->upload_map + offset, pixels, rows * stride);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, a->upload_buffer);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            a->upload_level,
+            0,
+            a->upload_row,
+            width,
+            rows,
+            format->format,
+            GL_UNSIGNED_BYTE,
+            (const void *) offset);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        *fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        a->upload_slice = (a->upload_slice + 1) % UPLOAD_SLICES;
+    } else {
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            a->upload_level,
+            0,
+            a->upload_row,
+            width,
+            rows,
+            format->format,
+            GL_UNSIGNED_BYTE,
+            pixels);
+    }
+
+    a->upload_row += rows;
+    if (a->upload_row < height) {
+        return true;
+    }
+
+    a->upload_row = 0;
+    a->upload_level++;
+    if (image->mipmaps && a->upload_level < mipmap_levels(image->width, image->height)) {
+        return true;
+    }
+
+    // Screenshots and mapped pixels come without a prebuilt chain
+    if (!image->mipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    Image *uploaded = &a->images.data[a->upload_image];
+    uploaded->texture = a->upload_texture;
+    a->upload_texture = 0;
+    a->texture_count++;
+    a->texture_bytes += image_texture_size(uploaded);
+
+    app_show_image(a, a->upload_image);
+    a->upload_image = SIZE_MAX;
+    return false;
+}
+
+static void app_push_decode(App *a, const Image *image, bool preview) {
+    Decode *d = calloc(1, sizeof(*d));
+    if (!d || !(d->path = strdup(a->paths.data + image->path))) {
+        fprintf(stderr, "ERROR: Could not allocate decode job\n");
+        exit(1);
+    }
+
+    d->key = image->path;
+    d->preview = preview;
+    d->mipmapped = !a->use_cpu && !preview;
+    d->channels = a->use_cpu ? 4 : 0; // The CPU renderer samples packed RGBA only
+    d->cache = &a->cache;
+    d->screen_width = a->size.x;
+    d->screen_height = a->size.y;
+    worker_push(&a->worker, decode_run, d);
+}
+
 static void app_load_image(App *a, bool next_if_failed) {
-    while (true) {
-        Image *image = &a->images.data[a->current];
-        if (image->type == IMAGE_FILE_QUEUED) {
-            const char *path = a->paths.data + image->path;
-
-            int    w, h;
-            Pixel *data = (Pixel *) stbi_load(path, &w, &h, NULL, 4);
-            if (!data) {
-                fprintf(stderr, "ERROR: Could not load image '%s'\n", path);
-
-                da_remove(&a->images, a->current);
-                if (a->images.count == 0) {
-                    fprintf(
-                        stderr, "ERROR: Could not load any of the requested images! Exiting...\n");
-                    exit(1);
-                }
+    Image *image = &a->images.data[a->current];
+    a->load_forward = next_if_failed;
+
+    if (image->type == IMAGE_FILE_QUEUED) {
+        // The preview is queued first, so it gets shown while the full image still decodes
+        app_push_decode(a, image, true);
+        app_push_decode(a, image, false);
+        image->type = IMAGE_FILE_LOADING;
+    }
 
-                if (next_if_failed) {
-                    if (a->current == a->images.count) {
-                        a->current = 0;
-                    }
-                } else {
-                    if (a->current) {
-                        a->current--;
-                    } else {
-                        a->current = a->images.count - 1;
-                    }
-                }
-                continue;
+    // Picked up again by app_finish_decode() once the pixels are there
+    if (image->type == IMAGE_FILE_LOADING) {
+        a->upload_image = SIZE_MAX;
+        return;
+    }
+
+    // The CPU renderer samples the pixels in place, and recently shown images are still resident
+    if (a->use_cpu || image->texture) {
+        a->upload_image = SIZE_MAX;
+        app_show_image(a, a->current);
+    } else {
+        app_upload_image(a, a->current);
+    }
+}
+
+// Quarter turns and mirroring of the orientations defined by EXIF, indexed by their value
+static const struct {
+    uint8_t rotation;
+    bool    flip;
+} exif_orientations[] = {
+    [1] = {0, false},
+    [2] = {0, true},
+    [3] = {2, false},
+    [4] = {2, true},
+    [5] = {3, true},
+    [6] = {1, false},
+    [7] = {1, true},
+    [8] = {3, false},
+};
+
+// Shows the embedded thumbnail of an image which is still decoding, scaled up to the size of the
+// full image so it can be swapped in later without moving
+static void app_show_preview(App *a, size_t index, Decode *d) {
+    Image *image = &a->images.data[index];
+    image->width = d->image_width;
+    image->height = d->image_height;
+    image->rotation = exif_orientations[d->orientation].rotation;
+    image->flip = exif_orientations[d->orientation].flip;
+
+    image_free(&a->preview);
+    a->preview = (Image) {
+        .data = d->data,
+        .width = d->width,
+        .height = d->height,
+        .channels = d->channels,
+    };
+    d->data = NULL;
+
+    if (!a->use_cpu) {
+        const TextureFormat *format = &texture_formats[a->preview.channels];
+
+        glBindTexture(GL_TEXTURE_2D, a->preview_texture);
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, format->swizzle);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            format->internal,
+            a->preview.width,
+            a->preview.height,
+            0,
+            format->format,
+            GL_UNSIGNED_BYTE,
+            a->preview.data);
+    }
+
+    app_show_image(a, index);
+    a->preview_shown = true;
+}
+
+static void app_finish_decode(App *a, Decode *d) {
+    size_t index = 0;
+    while (index < a->images.count) {
+        const Image *image = &a->images.data[index];
+        if (image->type == IMAGE_FILE_LOADING && image->path == d->key) break;
+        index++;
+    }
+
+    if (index == a->images.count) {
+        decode_free(d);
+        return;
+    }
+
+    if (d->preview) {
+        if (d->data && index == a->current) {
+            app_show_preview(a, index, d);
+        }
+        decode_free(d);
+        return;
+    }
+
+    if (!d->data) {
+        fprintf(stderr, "ERROR: Could not load image '%s'\n", d->path);
+        decode_free(d);
+
+        const bool current = index == a->current;
+        app_remove_image(a, index);
+        if (a->images.count == 0) {
+            fprintf(stderr, "ERROR: Could not load any of the requested images! Exiting...\n");
+            exit(1);
+        }
+
+        if (!current) {
+            if (index < a->current) a->current--;
+            return;
+        }
+
+        if (a->load_forward) {
+            if (a->current == a->images.count) {
+                a->current = 0;
+            }
+        } else {
+            if (a->current) {
+                a->current--;
+            } else {
+                a->current = a->images.count - 1;
+            }
+        }
+
+        app_load_image(a, a->load_forward);
+        return;
+    }
+
+    Image *image = &a->images.data[index];
+    image->data = d->data;
+    image->mipmaps = d->mipmaps;
+
+    // The preview already applied the orientation, which may have been changed since
+    if (!image->width) {
+        image->rotation = exif_orientations[d->orientation].rotation;
+        image->flip = exif_orientations[d->orientation].flip;
+    }
+
+    image->width = d->width;
+    image->height = d->height;
+    image->channels = d->channels;
+    image->animated = d->animated;
+    image->type = IMAGE_FILE_LOADED;
+
+    d->mipmaps = NULL;
+    if (d->store) {
+        free(d->path);
+        d->path = NULL;
+        worker_push(&a->cache_worker, store_run, d);
+    } else {
+        d->data = NULL;
+        decode_free(d);
+    }
+
+    if (index == a->current) {
+        app_load_image(a, a->load_forward);
+    }
+}
+
+static void animation_run(void *data) {
+    Animation *an = data;
+
+    const size_t slot = an->decoding_slot;
+    int          delay = 0;
+    an->failed = !gif_next(an->gif, an->frames[slot], &delay);
+
+    // Like browsers do, delays too short to be intended fall back to a sensible default
+    an->delays[slot] = delay < ANIMATION_DELAY_MIN ? ANIMATION_DELAY_DEFAULT : delay;
+}
+
+static void animation_free(void *data) {
+    Animation *an = data;
+    if (an->gif) gif_close(an->gif);
+    if (an->file) munmap(an->file, an->size);
+    for (size_t i = 0; i < ANIMATION_FRAMES; i++) {
+        free(an->frames[i]);
+    }
+    free(an->screen);
+    free(an);
+}
+
+static void app_stop_animation(App *a) {
+    if (!a->animation) {
+        return;
+    }
+
+    // The worker still writes into a frame being decoded, so it is freed once it comes back
+    if (!a->animation->decoding) {
+        animation_free(a->animation);
+    }
+    a->animation = NULL;
+}
+
+static void app_start_animation(App *a, const Image *image) {
+    Animation *an = calloc(1, sizeof(*an));
+    if (!an) {
+        fprintf(stderr, "ERROR: Could not allocate animation\n");
+        exit(1);
+    }
+
+    struct stat statbuf = {0};
+    an->path = image->path;
+    an->file = map_file(a->paths.data + image->path, &statbuf);
+    an->size = statbuf.st_size;
+    an->gif = an->file ? gif_open(an->file, an->size) : NULL;
+
+    // The frames are uploaded over the first one, so they have to match it
+    size_t width = 0, height = 0;
+    if (an->gif) gif_size(an->gif, &width, &height);
+    if (width != image->width || height != image->height || image->channels != 4) {
+        animation_free(an);
+        return;
+    }
+
+    for (size_t i = 0; i < ANIMATION_FRAMES; i++) {
+        an->frames[i] = malloc(width * height * 4);
+        if (!an->frames[i]) {
+            animation_free(an);
+            return;
+        }
+    }
+
+    an->due = get_time();
+    a->animation = an;
+}
+
+// Replaces the shown image with the next frame of its animation once it is due, and keeps the
+// ring of decoded frames filled. Returns whether a frame was shown, and sets the time until the
+// next one is due, negative if it is not decoded yet
+static bool app_animate(App *a, double *timeout) {
+    *timeout = -1;
+
+    Image *image = NULL;
+    if (a->shown != SIZE_MAX && !a->preview_shown && !a->grid_on) {
+        image = &a->images.data[a->shown];
+    }
+
+    if (a->animation && (!image || a->animation->path != image->path)) {
+        app_stop_animation(a);
+    }
+
+    if (!image || !image->animated) {
+        return false;
+    }
+
+    if (!a->animation) {
+        app_start_animation(a, image);
+        if (!a->animation) {
+            image->animated = false;
+            return false;
+        }
+    }
+
+    Animation   *an = a->animation;
+    const double now = get_time();
+
+    bool shown = false;
+    if (an->count && now >= an->due) {
+        const uint8_t *frame = an->frames[an->head];
+        // The slot gets decoded into again, and the still stays as is for whatever else reads it
+        if (a->use_cpu) {
+            if (!an->screen && !(an->screen = malloc(image->width * image->height * 4))) {
+                fprintf(stderr, "ERROR: Could not allocate animation frame\n");
+                exit(1);
             }
+            memcpy(an->screen, frame, image->width * image->height * 4);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, image->texture);
+            glTexSubImage2D(
+                GL_TEXTURE_2D,
+                0,
+                0,
+                0,
+                image->width,
+                image->height,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                frame);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        // Frames keep their cadence, unless playback fell behind by more than a whole frame
+        const double delay = an->delays[an->head] / 1000.0;
+        an->due = an->due + delay < now ? now + delay : an->due + delay;
+        an->head = (an->head + 1) % ANIMATION_FRAMES;
+        an->count--;
+        shown = true;
+    }
+
+    if (!an->decoding && !an->failed && an->count < ANIMATION_FRAMES) {
+        an->decoding = true;
+        an->decoding_slot = (an->head + an->count) % ANIMATION_FRAMES;
+        worker_push(&a->animation_worker, animation_run, an);
+    }
+
+    if (an->count) {
+        *timeout = max(an->due - now, 0);
+    }
+    return shown;
+}
+
+static void app_finish_animation(App *a, Animation *an) {
+    if (an != a->animation) {
+        animation_free(an);
+        return;
+    }
+
+    an->decoding = false;
+    if (!an->failed) {
+        an->count++;
+    }
+}
+
+// Keeps the screenshot on screen up to date with what is underneath the window
+static void app_live_start(App *a) {
+    // Thumbnail jobs which outlived the grid may still read the pixels of the screenshot
+    Image *image = &a->images.data[a->shown];
+    if (image->type != IMAGE_SCREENSHOT || (!a->use_cpu && !image->texture) || a->grid_pending) {
+        return;
+    }
+
+    if (!live_start(&a->live, a->display, a->window, image->width, image->height)) {
+        fprintf(stderr, "ERROR: Live mode needs XDamage, MIT-SHM and a compositing manager\n");
+        return;
+    }
+
+    a->live_on = true;
+    a->live_image = a->shown;
 
-            image->width = a->size.x;
-            image->height = a->size.y;
-            if (w > image->width || h > image->height) {
-                const float ax = (float) w / image->width;
-                const float ay = (float) h / image->height;
-                const float scale = ax > ay ? ax : ay;
+    // Rebuilding the mipmaps on every update would cost as much as capturing the whole screen
+    if (!a->use_cpu) {
+        glBindTexture(GL_TEXTURE_2D, image->texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    }
+}
+
+static void app_live_stop(App *a) {
+    live_stop(&a->live);
+    a->live_on = false;
+
+    const Image *image = &a->images.data[a->live_image];
+    if (!a->use_cpu && image->texture) {
+        glBindTexture(GL_TEXTURE_2D, image->texture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+    }
+}
+
+// Returns whether anything changed
+static bool app_live_update(App *a) {
+    const Image *image = &a->images.data[a->live_image];
+    const size_t count = live_update(&a->live, image->data, image->channels);
+    if (!count || a->use_cpu || !image->texture) {
+        return count;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, image->texture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, image->width);
+    for (size_t i = 0; i < count; i++) {
+        const XRectangle r = a->live.updated[i];
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            r.x,
+            r.y,
+            r.width,
+            r.height,
+            texture_formats[image->channels].format,
+            GL_UNSIGNED_BYTE,
+            image->data + (r.y * image->width + r.x) * image->channels);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    return true;
+}
+
+static size_t app_grid_columns(const App *a) {
+    return max(a->size.x / GRID_CELL_SIZE, 1);
+}
+
+// Rows which are at least partially on screen
+static void app_grid_rows(const App *a, size_t *first, size_t *last) {
+    *first = a->grid_scroll / GRID_CELL_SIZE;
+    *last = (a->grid_scroll + a->size.y) / GRID_CELL_SIZE + 1;
+}
+
+static void app_grid_scroll(App *a, float delta) {
+    const size_t rows = (a->images.count + app_grid_columns(a) - 1) / app_grid_columns(a);
+    const float  end = max((float) rows * GRID_CELL_SIZE - a->size.y, 0);
+    a->grid_scroll = fmin(fmax(a->grid_scroll + delta, 0), end);
+}
+
+// Selects an image and scrolls just enough to bring it into view
+static void app_grid_select(App *a, size_t index) {
+    const float top = index / app_grid_columns(a) * GRID_CELL_SIZE;
+    if (top < a->grid_scroll) {
+        app_grid_scroll(a, top - a->grid_scroll);
+    } else if (top + GRID_CELL_SIZE > a->grid_scroll + a->size.y) {
+        app_grid_scroll(a, top + GRID_CELL_SIZE - a->size.y - a->grid_scroll);
+    }
+    a->grid_selected = index;
+}
 
-                image->width = floor(image->width * scale);
-                image->height = floor(image->height * scale);
-            }
+static void app_grid_open_gl(App *a) {
+    a->grid_program = compile_program(grid_vs, grid_fs);
+    a->grid_uniform_screen = get_uniform(a->grid_program, "screen");
+
+    glUseProgram(a->grid_program);
+    glUniform4f(get_uniform(a->grid_program, "background"), BACKGROUND_COLOR);
+    glUniform4f(get_uniform(a->grid_program, "placeholder_color"), GRID_PLACEHOLDER_COLOR);
+    glUniform4f(get_uniform(a->grid_program, "select_color"), SELECTION_COLOR);
+    glUniform1f(get_uniform(a->grid_program, "border"), GRID_BORDER_SIZE);
+
+    // The corners of the cells come from gl_VertexID, so the only attributes are per instance
+    glGenVertexArrays(1, &a->grid_vao);
+    glGenBuffers(1, &a->grid_vbo);
+    glBindVertexArray(a->grid_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, a->grid_vbo);
+
+    static const struct {
+        GLint  size;
+        size_t offset;
+    } attributes[] = {
+        {4, offsetof(GridInstance, cell)},
+        {4, offsetof(GridInstance, image)},
+        {4, offsetof(GridInstance, atlas)},
+        {4, offsetof(GridInstance, orientation)},
+        {2, offsetof(GridInstance, flags)},
+    };
 
-            image->data = malloc(image->width * image->height * sizeof(Pixel));
-            if (!image->data) {
-                fprintf(stderr, "ERROR: Could not allocate image buffer\n");
-                exit(1);
-            }
+    for (size_t i = 0; i < sizeof(attributes) / sizeof(*attributes); i++) {
+        glVertexAttribPointer(
+            i,
+            attributes[i].size,
+            GL_FLOAT,
+            GL_FALSE,
+            sizeof(GridInstance),
+            (void *) attributes[i].offset);
+        glVertexAttribDivisor(i, 1);
+        glEnableVertexAttribArray(i);
+    }
 
-            const size_t x = (image->width - w) / 2;
-            const size_t y = (image->height - h) / 2;
-            for (size_t j = 0; j < image->height; ++j) {
-                for (size_t i = 0; i < image->width; ++i) {
-                    if (i >= x && i < x + w && j >= y && j < y + h) {
-                        image->data[j * (size_t) image->width + i] = data[(j - y) * w + (i - x)];
-                    } else {
-                        const Vec4 c = vec4_scale((Vec4) {BACKGROUND_COLOR}, 0xFF);
-                        image->data[j * (size_t) image->width + i] = (Pixel) {c.x, c.y, c.z, c.w};
-                    }
-                }
-            }
+    // The atlas has enough cells for every image in range at once, which bounds the memory no
+    // matter how many images there are
+    const size_t per_row = GRID_ATLAS_SIZE / GRID_THUMB_SIZE;
+    const size_t per_layer = per_row * per_row;
+    const size_t rows = a->size.y / GRID_CELL_SIZE + 2 + GRID_PRELOAD_ROWS * 2;
+    const size_t layers = (rows * app_grid_columns(a) + per_layer - 1) / per_layer;
+
+    a->grid_slots = layers * per_layer;
+    a->grid_owners = malloc(a->grid_slots * sizeof(*a->grid_owners));
+    if (!a->grid_owners) {
+        fprintf(stderr, "ERROR: Could not allocate thumbnail atlas\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < a->grid_slots; i++) {
+        a->grid_owners[i] = SIZE_MAX;
+    }
 
-            stbi_image_free(data);
-            image->type = IMAGE_FILE_LOADED;
-        }
+    glGenTextures(1, &a->grid_atlas);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, a->grid_atlas);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-        glTexImage2D(
-            GL_TEXTURE_2D,
+    if (a->texture_storage) {
+        glTexStorage3D(
+            GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, GRID_ATLAS_SIZE, GRID_ATLAS_SIZE, layers);
+    } else {
+        glTexImage3D(
+            GL_TEXTURE_2D_ARRAY,
             0,
-            GL_RGBA,
-            image->width,
-            image->height,
+            GL_RGBA8,
+            GRID_ATLAS_SIZE,
+            GRID_ATLAS_SIZE,
+            layers,
             0,
             GL_RGBA,
             GL_UNSIGNED_BYTE,
-            image->data);
+            NULL);
+    }
 
-        glGenerateMipmap(GL_TEXTURE_2D);
+    worker_init(&a->grid_worker, 0);
+}
+
+static void app_grid_toggle(App *a) {
+    if (a->grid_on) {
+        // Nothing is in range anymore, so the jobs still queued are dropped
+        atomic_store(&a->grid_range.last, 0);
+        a->grid_on = false;
+        return;
+    }
+
+    // Thumbnails are made from the pixels of the screenshot on other threads
+    if (a->live_on) {
+        app_live_stop(a);
+    }
+
+    if (!a->grid_atlas) {
+        app_grid_open_gl(a);
+    }
+
+    a->grid_on = true;
+    app_grid_scroll(a, 0);
+    app_grid_select(a, a->current);
+}
+
+static void app_grid_open_image(App *a, size_t index) {
+    app_grid_toggle(a);
+    if (index != a->current) {
+        a->current = index;
+        app_load_image(a, true);
+    }
+}
+
+static void app_grid_request(App *a, size_t first, size_t last) {
+    for (size_t i = first; i < last && a->grid_pending < GRID_JOBS_MAX; i++) {
+        Image *image = &a->images.data[i];
+        if (image->thumb.state != THUMB_NONE) {
+            continue;
+        }
+
+        ThumbJob *t = calloc(1, sizeof(*t));
+        if (!t) {
+            fprintf(stderr, "ERROR: Could not allocate thumbnail job\n");
+            exit(1);
+        }
+
+        t->range = &a->grid_range;
+        t->index = i;
+        t->generation = atomic_load(&a->grid_range.generation);
+        t->cache = &a->cache;
+        t->screen_width = a->size.x;
+        t->screen_height = a->size.y;
+
+        if (image->data) {
+            t->source = image->data;
+            t->source_width = image->width;
+            t->source_height = image->height;
+            t->source_channels = image->channels;
+        } else if (!(t->path = strdup(a->paths.data + image->path))) {
+            fprintf(stderr, "ERROR: Could not allocate thumbnail job\n");
+            exit(1);
+        }
+
+        image->thumb.state = THUMB_PENDING;
+        a->grid_pending++;
+        worker_push(&a->grid_worker, thumb_run, t);
+    }
+}
+
+// Frees the thumbnails which scrolled out of range and requests the missing ones, the visible
+// rows before the ones around them
+static void app_grid_update(App *a) {
+    const size_t columns = app_grid_columns(a);
+
+    size_t first_row, last_row;
+    app_grid_rows(a, &first_row, &last_row);
+
+    const size_t first = (first_row - min(first_row, GRID_PRELOAD_ROWS)) * columns;
+    const size_t last = min((last_row + GRID_PRELOAD_ROWS) * columns, a->images.count);
+    atomic_store(&a->grid_range.first, first);
+    atomic_store(&a->grid_range.last, last);
+
+    for (size_t i = 0; i < a->grid_slots; i++) {
+        const size_t owner = a->grid_owners[i];
+        if (owner != SIZE_MAX && (owner < first || owner >= last)) {
+            a->images.data[owner].thumb.state = THUMB_NONE;
+            a->grid_owners[i] = SIZE_MAX;
+        }
+    }
+
+    app_grid_request(a, first_row * columns, min(last_row * columns, a->images.count));
+    app_grid_request(a, first, last);
+}
+
+static void app_grid_finish(App *a, ThumbJob *t) {
+    a->grid_pending--;
+
+    Image *image = t->index < a->images.count ? &a->images.data[t->index] : NULL;
+    if (t->generation != atomic_load(&a->grid_range.generation) || !image ||
+        image->thumb.state != THUMB_PENDING) {
+        thumb_free(t);
+        return;
+    }
+
+    Thumb *thumb = &image->thumb;
+    if (t->skipped) {
+        thumb->state = THUMB_NONE;
+    } else if (!t->data) {
+        thumb->state = THUMB_FAILED;
+    } else {
+        size_t slot = 0;
+        while (slot < a->grid_slots && a->grid_owners[slot] != SIZE_MAX) slot++;
+
+        if (slot == a->grid_slots) {
+            thumb->state = THUMB_NONE;
+        } else {
+            const size_t per_row = GRID_ATLAS_SIZE / GRID_THUMB_SIZE;
+            const size_t per_layer = per_row * per_row;
+            const size_t cell = slot % per_layer;
+
+            glBindTexture(GL_TEXTURE_2D_ARRAY, a->grid_atlas);
+            glTexSubImage3D(
+                GL_TEXTURE_2D_ARRAY,
+                0,
+                cell % per_row * GRID_THUMB_SIZE,
+                cell / per_row * GRID_THUMB_SIZE,
+                slot / per_layer,
+                t->width,
+                t->height,
+                1,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                t->data);
+
+            a->grid_owners[slot] = t->index;
+            *thumb = (Thumb) {
+                .state = THUMB_READY,
+                .slot = slot,
+                .width = t->width,
+                .height = t->height,
+                .orientation = t->orientation,
+            };
+        }
+    }
+
+    thumb_free(t);
+}
+
+static void app_grid_key(App *a, KeySym key) {
+    const size_t columns = app_grid_columns(a);
+    const size_t count = a->images.count;
+    const size_t selected = a->grid_selected;
+
+    switch (key) {
+    case 'n':
+    case 'l':
+    case XK_Right:
+        app_grid_select(a, (selected + 1) % count);
+        break;
+
+    case 'p':
+    case 'h':
+    case XK_Left:
+        app_grid_select(a, selected ? selected - 1 : count - 1);
+        break;
+
+    case 'j':
+    case XK_Down:
+        if (selected + columns < count) app_grid_select(a, selected + columns);
+        break;
+
+    case 'k':
+    case XK_Up:
+        if (selected >= columns) app_grid_select(a, selected - columns);
+        break;
+
+    case XK_Return:
+        app_grid_open_image(a, selected);
+        break;
+
+    case 'g':
+    case XK_Escape:
+        app_grid_toggle(a);
         break;
     }
+}
 
-    a->final.zoom = 1.0;
-    a->final.offset = vec2_scale(a->size, 0.5);
+static void app_grid_button(App *a, const XButtonEvent *e) {
+    switch (e->button) {
+    case Button1: {
+        const size_t columns = app_grid_columns(a);
+        const float  left = (a->size.x - (float) columns * GRID_CELL_SIZE) / 2;
+        if (e->x < left || e->x >= left + columns * GRID_CELL_SIZE) break;
+
+        const size_t column = (e->x - left) / GRID_CELL_SIZE;
+        const size_t row = (e->y + a->grid_scroll) / GRID_CELL_SIZE;
+        if (row * columns + column < a->images.count) {
+            app_grid_open_image(a, row * columns + column);
+        }
+    } break;
+
+    case Button4:
+        app_grid_scroll(a, -GRID_SCROLL_STEP);
+        break;
+
+    case Button5:
+        app_grid_scroll(a, GRID_SCROLL_STEP);
+        break;
+    }
 }
 
 static const char *compare_context;
@@ -195,7 +1412,7 @@ static int compare_images(const void *a, const void *b) {
 static void app_add_file_to_queue(App *a, size_t path) {
     const char *this = a->paths.data + path;
     for (size_t i = 0; i < a->images.count; i++) {
-        if (a->images.data[i].type) {
+        if (image_is_file(&a->images.data[i])) {
             const char *that = a->paths.data + a->images.data[i].path;
             if (!strcmp(this, that)) {
                 return;
@@ -260,79 +1477,367 @@ defer:
     return result;
 }
 
-static void app_load_path(App *a, const char *path) {
-    struct stat statbuf = {0};
-    if (stat(path, &statbuf) < 0) {
-        fprintf(stderr, "ERROR: Could not stat file '%s'\n", path);
-        return;
-    }
+static void app_load_path(App *a, const char *path) {
+    struct stat statbuf = {0};
+    if (stat(path, &statbuf) < 0) {
+        fprintf(stderr, "ERROR: Could not stat file '%s'\n", path);
+        return;
+    }
+
+    if (S_ISDIR(statbuf.st_mode)) {
+        app_load_dir(a, path, true);
+        return;
+    }
+
+    const size_t copied = a->paths.count;
+    da_append_cstr(&a->paths, path);
+    da_append(&a->paths, '\0');
+    app_add_file_to_queue(a, copied);
+}
+
+void app_init(App *a) {
+    a->display = XOpenDisplay(NULL);
+    if (!a->display) {
+        fprintf(stderr, "ERROR: Could not open display\n");
+        exit(1);
+    }
+
+    XWindowAttributes wa = {0};
+    XGetWindowAttributes(a->display, DefaultRootWindow(a->display), &wa);
+    a->size = (Vec2) {wa.width, wa.height};
+}
+
+typedef struct {
+    Vec2 pos;
+    Vec2 uv;
+} Vertex;
+
+static int ipc_create_lock(void) {
+    const int fd = open(IPC_LOCK_FILE, O_CREAT | O_RDWR, 0666);
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (lockf(fd, F_TLOCK, 0) < 0) {
+        return -1;
+    }
+
+    ftruncate(fd, 0);
+    return fd;
+}
+
+static Window ipc_read_window(void) {
+    for (size_t i = 0; i < IPC_READ_MAX_TRIES; i++) {
+        FILE *f = fopen(IPC_LOCK_FILE, "r");
+        if (f) {
+            Window window = 0;
+            if (fscanf(f, "%lu", &window) == 1 && window) {
+                fclose(f);
+                return window;
+            }
+            fclose(f);
+        }
+        usleep(IPC_READ_DELAY_MS * 1000);
+    }
+
+    return 0;
+}
+
+static void ipc_write_window(int lock, Window window) {
+    dprintf(lock, "%lu\n", window);
+    fsync(lock);
+}
+
+static struct sockaddr_un ipc_socket_address(void) {
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    static_assert(sizeof(address.sun_path) >= sizeof(IPC_SOCKET_PATH), "");
+    memcpy(address.sun_path, IPC_SOCKET_PATH, sizeof(IPC_SOCKET_PATH));
+    return address;
+}
+
+static int ipc_create_socket(void) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    // The lock is held at this point, so whatever is left on this path is stale
+    unlink(IPC_SOCKET_PATH);
+
+    const struct sockaddr_un address = ipc_socket_address();
+    if (bind(fd, (const struct sockaddr *) &address, sizeof(address)) < 0 || listen(fd, 8) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+typedef struct {
+    uint64_t width;
+    uint64_t height;
+} IpcPixelsHeader;
+
+typedef union {
+    char           data[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+} IpcControl;
+
+static bool ipc_send_pixels(const Pixels *pixels) {
+    bool result = true;
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return_defer(false);
+    }
+
+    const struct sockaddr_un address = ipc_socket_address();
+    for (size_t i = 0; connect(fd, (const struct sockaddr *) &address, sizeof(address)) < 0; i++) {
+        if (i + 1 >= IPC_READ_MAX_TRIES) {
+            return_defer(false);
+        }
+        usleep(IPC_READ_DELAY_MS * 1000);
+    }
+
+    IpcPixelsHeader header = {.width = pixels->width, .height = pixels->height};
+    struct iovec    iov = {.iov_base = &header, .iov_len = sizeof(header)};
+
+    IpcControl    control = {0};
+    struct msghdr message = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.data,
+        .msg_controllen = sizeof(control.data),
+    };
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &pixels->fd, sizeof(int));
+
+    if (sendmsg(fd, &message, MSG_NOSIGNAL) != sizeof(header)) {
+        return_defer(false);
+    }
+
+defer:
+    if (fd >= 0) close(fd);
+    return result;
+}
+
+static bool ipc_recv_pixels(int fd, Pixels *pixels) {
+    const struct timeval timeout = {.tv_usec = IPC_READ_DELAY_MS * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    IpcPixelsHeader header = {0};
+    struct iovec    iov = {.iov_base = &header, .iov_len = sizeof(header)};
+
+    IpcControl    control = {0};
+    struct msghdr message = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.data,
+        .msg_controllen = sizeof(control.data),
+    };
+
+    if (recvmsg(fd, &message, MSG_CMSG_CLOEXEC) != sizeof(header)) {
+        return false;
+    }
+
+    const struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+        return false;
+    }
+
+    memcpy(&pixels->fd, CMSG_DATA(cmsg), sizeof(int));
+    pixels->width = header.width;
+    pixels->height = header.height;
+    return true;
+}
+
+// Takes ownership of the memfd. The seals guarantee the sender can neither modify nor truncate
+// the pixels after the fact, so they are mapped and uploaded in place without any copy
+static bool app_add_pixels(App *a, Pixels pixels) {
+    bool result = true;
+
+    const int required = F_SEAL_WRITE | F_SEAL_SHRINK;
+    if ((fcntl(pixels.fd, F_GET_SEALS) & required) != required) {
+        fprintf(stderr, "ERROR: Received pixel buffer is not sealed\n");
+        return_defer(false);
+    }
+
+    const size_t limit = SIZE_MAX / sizeof(Pixel);
+    if (!pixels.width || !pixels.height || pixels.width > limit / pixels.height) {
+        fprintf(stderr, "ERROR: Invalid pixel buffer size %zux%zu\n", pixels.width, pixels.height);
+        return_defer(false);
+    }
+
+    const size_t size = pixels.width * pixels.height * sizeof(Pixel);
+    struct stat  statbuf = {0};
+    if (fstat(pixels.fd, &statbuf) < 0 || (size_t) statbuf.st_size < size) {
+        fprintf(stderr, "ERROR: Received pixel buffer is too small\n");
+        return_defer(false);
+    }
+
+    uint8_t *data = mmap(NULL, size, PROT_READ, MAP_SHARED, pixels.fd, 0);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "ERROR: Could not map pixel buffer\n");
+        return_defer(false);
+    }
+
+    const Image image = {
+        .data = data,
+        .width = pixels.width,
+        .height = pixels.height,
+        .channels = sizeof(Pixel),
+        .type = IMAGE_MAPPED,
+    };
+    da_append(&a->images, image);
+
+defer:
+    close(pixels.fd);
+    return result;
+}
+
+static void app_accept_pixels(App *a) {
+    while (true) {
+        const int fd = accept4(a->ipc_socket, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            break;
+        }
+
+        Pixels pixels = {0};
+        if (!ipc_recv_pixels(fd, &pixels)) {
+            fprintf(stderr, "ERROR: Could not receive pixel buffer\n");
+        } else if (app_add_pixels(a, pixels)) {
+            a->current = a->images.count - 1;
+            app_load_image(a, true);
+        }
+
+        close(fd);
+    }
+}
+
+static void app_open_gl(App *a) {
+    a->image_program = compile_program(image_vs, image_fs);
+    a->image_uniform_fit = get_uniform(a->image_program, "fit");
+    a->image_uniform_orientation = get_uniform(a->image_program, "orientation");
+    a->image_uniform_zoom = get_uniform(a->image_program, "zoom");
+    a->image_uniform_offset = get_uniform(a->image_program, "offset");
+
+    a->image_uniform_mouse = get_uniform(a->image_program, "mouse");
+    a->image_uniform_aspect = get_uniform(a->image_program, "aspect");
+
+    a->image_uniform_lens_size = get_uniform(a->image_program, "lens_size");
+    a->image_uniform_lens_color = get_uniform(a->image_program, "lens_color");
+
+    a->image_uniform_select_began = get_uniform(a->image_program, "select_began");
+    a->image_uniform_select_mouse = get_uniform(a->image_program, "select_mouse");
+    a->image_uniform_select_start = get_uniform(a->image_program, "select_start");
+
+    glUseProgram(a->image_program);
+    glUniform4f(get_uniform(a->image_program, "select_color"), SELECTION_COLOR);
+    glUniform4f(get_uniform(a->image_program, "background"), BACKGROUND_COLOR);
+
+    glGenVertexArrays(1, &a->vao);
+    glGenBuffers(1, &a->vbo);
+    glGenBuffers(1, &a->ebo);
+
+    glBindVertexArray(a->vao);
+
+    static const Vertex vertices[] = {
+        {{-1.0f, -1.0f}, {0.0f, 1.0f}},
+        {{1.0f, -1.0f}, {1.0f, 1.0f}},
+        {{1.0f, 1.0f}, {1.0f, 0.0f}},
+        {{-1.0f, 1.0f}, {0.0f, 0.0f}},
+    };
+    glBindBuffer(GL_ARRAY_BUFFER, a->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    static const GLuint indices[] = {0, 1, 2, 2, 3, 0};
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, a->ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, pos));
+    glEnableVertexAttribArray(0);
 
-    if (S_ISDIR(statbuf.st_mode)) {
-        app_load_dir(a, path, true);
-        return;
-    }
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, uv));
+    glEnableVertexAttribArray(1);
 
-    const size_t copied = a->paths.count;
-    da_append_cstr(&a->paths, path);
-    da_append(&a->paths, '\0');
-    app_add_file_to_queue(a, copied);
-}
+    // Software rasterizers pay for every pixel on the CPU, so while the camera moves they render
+    // into a smaller framebuffer which then gets stretched over the window
+    a->render_adaptive = gl_is_software();
+    a->render_scale = 1.0;
 
-void app_init(App *a) {
-    a->display = XOpenDisplay(NULL);
-    if (!a->display) {
-        fprintf(stderr, "ERROR: Could not open display\n");
-        exit(1);
-    }
+    if (a->render_adaptive) {
+        glGenTextures(1, &a->render_texture);
+        glBindTexture(GL_TEXTURE_2D, a->render_texture);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA8,
+            a->size.x * RENDER_SCALE_MAX,
+            a->size.y * RENDER_SCALE_MAX,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            NULL);
 
-    XWindowAttributes wa = {0};
-    XGetWindowAttributes(a->display, DefaultRootWindow(a->display), &wa);
-    a->size = (Vec2) {wa.width, wa.height};
-}
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-typedef struct {
-    Vec2 pos;
-    Vec2 uv;
-} Vertex;
+        glGenFramebuffers(1, &a->render_fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, a->render_fbo);
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, a->render_texture, 0);
 
-static int ipc_create_lock(void) {
-    const int fd = open(IPC_LOCK_FILE, O_CREAT | O_RDWR, 0666);
-    if (fd < 0) {
-        return -1;
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            a->render_adaptive = false;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
-    if (lockf(fd, F_TLOCK, 0) < 0) {
-        return -1;
-    }
+    a->texture_storage = gl_has_extension("GL_ARB_texture_storage");
 
-    ftruncate(fd, 0);
-    return fd;
-}
+    // Previews are always scaled up, so they need no mipmaps
+    glGenTextures(1, &a->preview_texture);
+    glBindTexture(GL_TEXTURE_2D, a->preview_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-static Window ipc_read_window(void) {
-    for (size_t i = 0; i < IPC_READ_MAX_TRIES; i++) {
-        FILE *f = fopen(IPC_LOCK_FILE, "r");
-        if (f) {
-            Window window = 0;
-            if (fscanf(f, "%lu", &window) == 1 && window) {
-                fclose(f);
-                return window;
-            }
-            fclose(f);
-        }
-        usleep(IPC_READ_DELAY_MS * 1000);
-    }
+    // Rows of single and three channel images are not necessarily aligned to 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    return 0;
-}
+    // Pixels are staged through a persistently mapped ring of slices, so uploads proceed
+    // asynchronously while the render thread only copies a bounded amount per frame
+    if (gl_has_extension("GL_ARB_buffer_storage")) {
+        const GLsizeiptr size = UPLOAD_SLICES * UPLOAD_SLICE_SIZE;
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
 
-static void ipc_write_window(int lock, Window window) {
-    dprintf(lock, "%lu\n", window);
-    fsync(lock);
+        glGenBuffers(1, &a->upload_buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, a->upload_buffer);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, NULL, flags);
+        a->upload_map = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
 }
 
 void app_open(App *a, const char **paths, size_t count) {
     const int lock = ipc_create_lock();
+    if (lock < 0 && a->pixels.width) {
+        if (!ipc_send_pixels(&a->pixels)) {
+            fprintf(stderr, "ERROR: Could not send pixel buffer to main instance\n");
+            exit(1);
+        }
+
+        close(a->pixels.fd);
+        XCloseDisplay(a->display);
+        exit(0);
+    }
+
     if (lock < 0) {
         Window target = ipc_read_window();
         if (!target) {
@@ -378,6 +1883,7 @@ void app_open(App *a, const char **paths, size_t count) {
 
     app_zero(a);
     a->camera = a->final;
+    a->ease.to = a->final;
 
     {
         int  x = 0, y = 0;
@@ -390,30 +1896,35 @@ void app_open(App *a, const char **paths, size_t count) {
         a->select_cursor = XCreateFontCursor(a->display, XC_crosshair);
     }
 
-    if (count) {
-        for (size_t i = 0; i < count; i++) {
-            app_load_path(a, paths[i]);
-        }
-    } else {
-        const Image image = {
-            .data = app_snap(a, (Vec2) {0}, a->size),
-            .width = a->size.x,
-            .height = a->size.y,
-        };
-        da_append(&a->images, image);
+    a->shown = SIZE_MAX;
+    a->upload_image = SIZE_MAX;
+    worker_init(&a->worker, DECODE_THREADS);
+    worker_init(&a->animation_worker, 1);
+    a->cache_worker.nice = CACHE_STORE_NICE;
+    worker_init(&a->cache_worker, 1);
+    cache_init(&a->cache);
+
+    a->ipc_socket = ipc_create_socket();
+    if (a->ipc_socket < 0) {
+        fprintf(stderr, "ERROR: Could not create IPC socket '%s'\n", IPC_SOCKET_PATH);
+        exit(1);
     }
 
+    const char *renderer = getenv(RENDERER_ENV);
+    const bool  force_cpu = renderer && !strcmp(renderer, "cpu");
+    const bool  force_gl = renderer && !strcmp(renderer, "gl");
+
     GLint        glx_attribs[] = {GLX_RGBA, GLX_DOUBLEBUFFER, GLX_DEPTH_SIZE, 24, None};
-    XVisualInfo *vi = glXChooseVisual(a->display, 0, glx_attribs);
-    if (!vi) {
-        fprintf(stderr, "ERROR: No appropriate visual found\n");
-        exit(1);
-    }
+    XVisualInfo *vi = force_cpu ? NULL : glXChooseVisual(a->display, 0, glx_attribs);
+
+    const int screen = DefaultScreen(a->display);
+    Visual   *visual = vi ? vi->visual : DefaultVisual(a->display, screen);
+    const int depth = vi ? vi->depth : DefaultDepth(a->display, screen);
 
     const Window root = DefaultRootWindow(a->display);
 
     XSetWindowAttributes wa;
-    wa.colormap = XCreateColormap(a->display, root, vi->visual, AllocNone);
+    wa.colormap = XCreateColormap(a->display, root, visual, AllocNone);
     wa.event_mask = ButtonPressMask | ButtonReleaseMask | KeyPressMask | PointerMotionMask |
                     ExposureMask | VisibilityChangeMask | FocusChangeMask;
 
@@ -428,9 +1939,9 @@ void app_open(App *a, const char **paths, size_t count) {
         a->size.x,
         a->size.y,
         0,
-        vi->depth,
+        depth,
         InputOutput,
-        vi->visual,
+        visual,
         CWColormap | CWEventMask | CWOverrideRedirect | CWSaveUnder,
         &wa);
 
@@ -438,8 +1949,52 @@ void app_open(App *a, const char **paths, size_t count) {
     ipc_write_window(lock, a->window);
     a->ipc_message_atom = XInternAtom(a->display, IPC_MESSAGE_LOAD, False);
 
-    a->glx_context = glXCreateContext(a->display, vi, NULL, GL_TRUE);
-    glXMakeCurrent(a->display, a->window, a->glx_context);
+    if (vi) {
+        a->glx_context = glXCreateContext(a->display, vi, NULL, GL_TRUE);
+        glXMakeCurrent(a->display, a->window, a->glx_context);
+    }
+
+    // Without GLX, or when it would be a software rasterizer anyway, frames are drawn on the CPU
+    a->use_cpu = !a->glx_context || (!force_gl && gl_is_software());
+    if (a->use_cpu) {
+        if (cpu_init(&a->cpu, a->display, a->window, visual, depth, a->size.x, a->size.y)) {
+            if (a->glx_context) {
+                glXMakeCurrent(a->display, None, NULL);
+                glXDestroyContext(a->display, a->glx_context);
+                a->glx_context = NULL;
+            }
+        } else if (a->glx_context) {
+            a->use_cpu = false;
+        } else {
+            fprintf(stderr, "ERROR: No appropriate visual found\n");
+            exit(1);
+        }
+    }
+
+    if (vi) {
+        XFree(vi);
+    }
+
+    // Images are only added once the renderer is known, as the CPU one samples packed RGBA only
+    if (a->pixels.width) {
+        if (!app_add_pixels(a, a->pixels)) {
+            exit(1);
+        }
+    } else if (count) {
+        for (size_t i = 0; i < count; i++) {
+            app_load_path(a, paths[i]);
+        }
+    } else {
+        const size_t channels = a->use_cpu ? 4 : 3;
+
+        const Image image = {
+            .data = app_snap(a, (Vec2) {0}, a->size, channels),
+            .width = a->size.x,
+            .height = a->size.y,
+            .channels = channels,
+        };
+        da_append(&a->images, image);
+    }
 
     XMapRaised(a->display, a->window);
     XGrabKeyboard(a->display, root, true, GrabModeAsync, GrabModeAsync, CurrentTime);
@@ -458,121 +2013,289 @@ void app_open(App *a, const char **paths, size_t count) {
     XSetInputFocus(a->display, a->window, RevertToParent, CurrentTime);
     XSelectInput(a->display, root, SubstructureNotifyMask);
 
-    a->image_program = compile_program(image_vs, image_fs);
-    a->image_uniform_zoom = get_uniform(a->image_program, "zoom");
-    a->image_uniform_offset = get_uniform(a->image_program, "offset");
+    if (!a->use_cpu) {
+        app_open_gl(a);
+    }
 
-    a->overlay_program = compile_program(overlay_vs, overlay_fs);
-    a->overlay_uniform_mouse = get_uniform(a->overlay_program, "mouse");
-    a->overlay_uniform_aspect = get_uniform(a->overlay_program, "aspect");
+    app_load_image(a, true);
+}
 
-    a->overlay_uniform_lens_size = get_uniform(a->overlay_program, "lens_size");
-    a->overlay_uniform_lens_color = get_uniform(a->overlay_program, "lens_color");
+static void app_draw_cpu(App *a) {
+    static const Image none = {0};
 
-    a->overlay_uniform_select_began = get_uniform(a->overlay_program, "select_began");
-    a->overlay_uniform_select_mouse = get_uniform(a->overlay_program, "select_mouse");
-    a->overlay_uniform_select_start = get_uniform(a->overlay_program, "select_start");
+    const Image *image = a->shown == SIZE_MAX ? &none : &a->images.data[a->shown];
+    const Image *pixels = a->preview_shown ? &a->preview : image;
+    const Vec2   mouse = {a->mouse.x / a->size.x, a->mouse.y / a->size.y};
 
-    glUseProgram(a->overlay_program);
-    glUniform4f(get_uniform(a->overlay_program, "select_color"), SELECTION_COLOR);
+    // The animation is only kept while the image it belongs to is shown
+    const uint8_t *data = pixels->data;
+    if (pixels == image && a->animation && a->animation->screen) {
+        data = a->animation->screen;
+    }
 
-    glGenVertexArrays(1, &a->vao);
-    glGenBuffers(1, &a->vbo);
-    glGenBuffers(1, &a->ebo);
+    CpuFrame frame = {
+        .image = (const uint32_t *) data,
+        .width = pixels->width,
+        .height = pixels->height,
 
-    glBindVertexArray(a->vao);
+        .fit = image->width ? app_image_fit(a, image) : (Vec2) {1.0, 1.0},
+        .zoom = a->camera.zoom,
+        .offset = {
+            2.0 * a->camera.offset.x / a->size.x - 1.0,
+            1.0 - 2.0 * a->camera.offset.y / a->size.y,
+        },
 
-    static const Vertex vertices[] = {
-        {{-1.0f, -1.0f}, {0.0f, 1.0f}},
-        {{1.0f, -1.0f}, {1.0f, 1.0f}},
-        {{1.0f, 1.0f}, {1.0f, 0.0f}},
-        {{-1.0f, 1.0f}, {0.0f, 0.0f}},
+        .background = {BACKGROUND_COLOR},
+
+        .mouse = mouse,
+        .lens_size = a->camera.lens_size,
+        .lens_color = a->camera.lens_color,
+
+        .select_began = a->select_began,
+        .select_mouse = mouse,
+        .select_start = {a->select_start.x / a->size.x, a->select_start.y / a->size.y},
+        .select_color = {SELECTION_COLOR},
     };
-    glBindBuffer(GL_ARRAY_BUFFER, a->vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    image_orientation(image, frame.orientation);
 
-    static const GLuint indices[] = {0, 1, 2, 2, 3, 0};
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, a->ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    cpu_draw(&a->cpu, &frame);
+}
 
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, pos));
-    glEnableVertexAttribArray(0);
+static void app_draw_grid(App *a) {
+    const size_t columns = app_grid_columns(a);
+    const float  left = (a->size.x - (float) columns * GRID_CELL_SIZE) / 2;
+    const float  margin = (GRID_CELL_SIZE - GRID_THUMB_SIZE) / 2.0 / GRID_CELL_SIZE;
+    const size_t per_row = GRID_ATLAS_SIZE / GRID_THUMB_SIZE;
+    const size_t per_layer = per_row * per_row;
+
+    size_t first_row, last_row;
+    app_grid_rows(a, &first_row, &last_row);
+
+    a->grid_instances.count = 0;
+    for (size_t i = first_row * columns; i < min(last_row * columns, a->images.count); i++) {
+        const Image *image = &a->images.data[i];
+        const Thumb *thumb = &image->thumb;
+
+        GridInstance instance = {
+            .cell = {
+                left + i % columns * GRID_CELL_SIZE,
+                i / columns * GRID_CELL_SIZE - a->grid_scroll,
+                GRID_CELL_SIZE,
+                GRID_CELL_SIZE,
+            },
+            .image = {margin, margin, 1 - 2 * margin, 1 - 2 * margin},
+            .flags = {-1, i == a->grid_selected},
+        };
 
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, uv));
-    glEnableVertexAttribArray(1);
+        if (thumb->state == THUMB_READY) {
+            // Images which were decoded already carry their own orientation, as it may have been
+            // changed since
+            Image oriented = {
+                .width = thumb->width,
+                .height = thumb->height,
+                .rotation = exif_orientations[thumb->orientation].rotation,
+                .flip = exif_orientations[thumb->orientation].flip,
+            };
+            if (image->width) {
+                oriented.rotation = image->rotation;
+                oriented.flip = image->flip;
+            }
 
-    glGenTextures(1, &a->texture);
-    glBindTexture(GL_TEXTURE_2D, a->texture);
+            const Vec2  size = image_size(&oriented);
+            const float scale = (float) GRID_THUMB_SIZE / GRID_CELL_SIZE / max(size.x, size.y);
+            instance.image[2] = size.x * scale;
+            instance.image[3] = size.y * scale;
+            instance.image[0] = (1 - instance.image[2]) / 2;
+            instance.image[1] = (1 - instance.image[3]) / 2;
+            image_orientation(&oriented, instance.orientation);
+
+            // Inset by half a texel so the neighbouring thumbnails never bleed in
+            const size_t cell = thumb->slot % per_layer;
+            const float  x = cell % per_row * GRID_THUMB_SIZE;
+            const float  y = cell / per_row * GRID_THUMB_SIZE;
+            instance.atlas[0] = (x + 0.5) / GRID_ATLAS_SIZE;
+            instance.atlas[1] = (y + 0.5) / GRID_ATLAS_SIZE;
+            instance.atlas[2] = (x + thumb->width - 0.5) / GRID_ATLAS_SIZE;
+            instance.atlas[3] = (y + thumb->height - 0.5) / GRID_ATLAS_SIZE;
+            instance.flags[0] = thumb->slot / per_layer;
+        }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        da_append(&a->grid_instances, instance);
+    }
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glViewport(0, 0, a->size.x, a->size.y);
+    glClearColor(BACKGROUND_COLOR);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-    app_load_image(a, true);
+    glUseProgram(a->grid_program);
+    glUniform2f(a->grid_uniform_screen, a->size.x, a->size.y);
+
+    glBindVertexArray(a->grid_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, a->grid_vbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        a->grid_instances.count * sizeof(GridInstance),
+        a->grid_instances.data,
+        GL_STREAM_DRAW);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, a->grid_atlas);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, a->grid_instances.count);
+
+    glXSwapBuffers(a->display, a->window);
 }
 
 void app_draw(App *a) {
-    glClearColor(BACKGROUND_COLOR);
-    glClear(GL_COLOR_BUFFER_BIT);
+    if (a->use_cpu) {
+        app_draw_cpu(a);
+        return;
+    }
 
-    {
-        glUseProgram(a->image_program);
-        glUniform1f(a->image_uniform_zoom, a->camera.zoom);
-        glUniform2f(
-            a->image_uniform_offset,
-            2.0 * a->camera.offset.x / a->size.x - 1.0,
-            1.0 - 2.0 * a->camera.offset.y / a->size.y);
+    if (a->grid_on) {
+        app_draw_grid(a);
+        return;
+    }
 
-        glBindTexture(GL_TEXTURE_2D, a->texture);
-        glBindVertexArray(a->vao);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    if (a->shown == SIZE_MAX) {
+        glClearColor(BACKGROUND_COLOR);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glXSwapBuffers(a->display, a->window);
+        return;
     }
 
-    {
-        glUseProgram(a->overlay_program);
-
-        glUniform1f(a->overlay_uniform_lens_size, a->camera.lens_size);
-        glUniform4f(
-            a->overlay_uniform_lens_color,
-            a->camera.lens_color.x,
-            a->camera.lens_color.y,
-            a->camera.lens_color.z,
-            a->camera.lens_color.w);
-
-        glUniform1f(a->overlay_uniform_aspect, a->size.x / a->size.y);
-        glUniform1i(a->overlay_uniform_select_began, a->select_began);
-
-        if (a->select_on || a->select_snap_pending) {
-            glUniform2f(
-                a->overlay_uniform_select_mouse, a->mouse.x / a->size.x, a->mouse.y / a->size.y);
-        } else {
-            glUniform2f(a->overlay_uniform_mouse, a->mouse.x / a->size.x, a->mouse.y / a->size.y);
-        }
+    // The image, the lens and the selection are composited in a single full screen pass, which
+    // covers every pixel, so there is no need to clear or blend
+    const Image *image = &a->images.data[a->shown];
+    const Vec2   fit = app_image_fit(a, image);
+
+    float orientation[4];
+    image_orientation(image, orientation);
+
+    glUseProgram(a->image_program);
+    glUniform2f(a->image_uniform_fit, fit.x, fit.y);
+    glUniformMatrix2fv(a->image_uniform_orientation, 1, GL_FALSE, orientation);
+    glUniform1f(a->image_uniform_zoom, a->camera.zoom);
+    glUniform2f(
+        a->image_uniform_offset,
+        2.0 * a->camera.offset.x / a->size.x - 1.0,
+        1.0 - 2.0 * a->camera.offset.y / a->size.y);
+
+    glUniform1f(a->image_uniform_lens_size, a->camera.lens_size);
+    glUniform4f(
+        a->image_uniform_lens_color,
+        a->camera.lens_color.x,
+        a->camera.lens_color.y,
+        a->camera.lens_color.z,
+        a->camera.lens_color.w);
+
+    glUniform1f(a->image_uniform_aspect, a->size.x / a->size.y);
+    glUniform1i(a->image_uniform_select_began, a->select_began);
+
+    if (a->select_on || a->select_snap_pending) {
+        glUniform2f(a->image_uniform_select_mouse, a->mouse.x / a->size.x, a->mouse.y / a->size.y);
+    } else {
+        glUniform2f(a->image_uniform_mouse, a->mouse.x / a->size.x, a->mouse.y / a->size.y);
+    }
 
-        glUniform2f(
-            a->overlay_uniform_select_start,
-            a->select_start.x / a->size.x,
-            a->select_start.y / a->size.y);
+    glUniform2f(
+        a->image_uniform_select_start,
+        a->select_start.x / a->size.x,
+        a->select_start.y / a->size.y);
+
+    const bool reduced = a->render_scale < 1.0;
+    const int  width = a->size.x * a->render_scale;
+    const int  height = a->size.y * a->render_scale;
+    if (reduced) {
+        glBindFramebuffer(GL_FRAMEBUFFER, a->render_fbo);
+    }
+    glViewport(0, 0, width, height);
 
-        glBindVertexArray(a->vao);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    glBindTexture(GL_TEXTURE_2D, a->preview_shown ? a->preview_texture : image->texture);
+    glBindVertexArray(a->vao);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+    if (reduced) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, a->render_fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(
+            0, 0, width, height, 0, 0, a->size.x, a->size.y, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
     glXSwapBuffers(a->display, a->window);
 }
 
+// Adjusts the resolution of moving frames so they fit the frame budget. Settled frames are always
+// drawn at full resolution
+static float app_adapt_render_scale(float scale, double elapsed) {
+    const double budget = 1.0 / FPS;
+    if (elapsed > budget) {
+        // The cost of a frame is proportional to its area
+        scale *= sqrt(budget / elapsed);
+    } else if (elapsed < budget * RENDER_SCALE_HEADROOM) {
+        scale *= 1.1;
+    }
+    return fmax(RENDER_SCALE_MIN, fmin(RENDER_SCALE_MAX, scale));
+}
+
+// Blocks until there is something to react to or the timeout expires, so an idle viewer costs
+// nothing. A negative timeout waits indefinitely
+static void app_wait(App *a, double timeout) {
+    struct pollfd fds[] = {
+        {.fd = ConnectionNumber(a->display), .events = POLLIN},
+        {.fd = a->ipc_socket, .events = POLLIN},
+        {.fd = a->worker.event, .events = POLLIN},
+        {.fd = a->grid_atlas ? a->grid_worker.event : -1, .events = POLLIN},
+        {.fd = a->animation_worker.event, .events = POLLIN},
+    };
+
+    const int ms = timeout < 0 ? -1 : ceil(timeout * 1000);
+    while (poll(fds, sizeof(fds) / sizeof(*fds), ms) < 0) {
+        if (errno != EINTR) {
+            fprintf(stderr, "ERROR: Could not wait for events\n");
+            exit(1);
+        }
+    }
+}
+
 void app_loop(App *a) {
-    double pt = get_time();
+    bool   redraw = true;
+    double frame = 0;
+    float  scale = RENDER_SCALE_MAX;
     while (true) {
-        const double dt = get_time() - pt;
-        if (!a->select_snap_pending) camera_update(&a->camera, &a->final, fmin(dt, 1.0 / FPS));
-        pt += dt;
+        const size_t shown = a->shown;
+        const bool   uploading = app_upload_step(a);
+        redraw |= a->shown != shown;
+
+        if (a->grid_on) {
+            app_grid_update(a);
+        }
+
+        double playing;
+        redraw |= app_animate(a, &playing);
+
+        if (a->live_on && a->shown != a->live_image) {
+            app_live_stop(a);
+        }
+        if (a->live_on) {
+            redraw |= app_live_update(a);
+        }
+
+        bool animating = false;
+        if (!a->select_snap_pending) {
+            animating = camera_update(&a->camera, &a->ease, &a->final, get_time());
+        }
+
+        if (redraw || animating || a->select_snap_pending || a->render_scale < 1.0) {
+            a->render_scale = animating && a->render_adaptive ? scale : 1.0;
+
+            frame = get_time();
+            app_draw(a);
+            if (a->render_scale < 1.0) {
+                scale = app_adapt_render_scale(scale, get_time() - frame);
+            }
+        }
+        redraw = false;
 
-        app_draw(a);
         if (a->select_snap_pending) {
             a->select_snap_pending--;
             if (!a->select_snap_pending) {
@@ -595,14 +2318,53 @@ void app_loop(App *a) {
             }
         }
 
+        if (!a->select_snap_pending && !XPending(a->display)) {
+            if (animating || uploading) {
+                // Frames are paced here as the swap is not guaranteed to wait for vsync, and the
+                // last frame of an animation is scheduled to land exactly on its deadline
+                double next = frame + 1.0 / FPS;
+                if (animating) next = min(next, camera_deadline(&a->ease));
+                const double now = get_time();
+                if (next > now) app_wait(a, next - now);
+            } else {
+                app_wait(a, playing);
+            }
+        }
+
+        const size_t count = a->images.count;
+        app_accept_pixels(a);
+        redraw |= a->images.count != count;
+
+        Decode *decode;
+        while ((decode = worker_pop(&a->worker))) {
+            app_finish_decode(a, decode);
+            redraw = true;
+        }
+
+        Animation *animation;
+        while ((animation = worker_pop(&a->animation_worker))) {
+            app_finish_animation(a, animation);
+        }
+
+        while ((decode = worker_pop(&a->cache_worker))) {
+            free(decode);
+        }
+
+        ThumbJob *thumb;
+        while (a->grid_atlas && (thumb = worker_pop(&a->grid_worker))) {
+            app_grid_finish(a, thumb);
+            redraw = true;
+        }
+
         while (XPending(a->display)) {
             XEvent e;
             XNextEvent(a->display, &e);
+            if (a->live_on) live_event(&a->live, &e);
             if (e.type != Expose && a->select_snap_pending) continue;
+            redraw = true;
 
             switch (e.type) {
             case Expose:
-                app_draw(a);
                 break;
 
             case FocusOut:
@@ -651,6 +2413,11 @@ void app_loop(App *a) {
                 break;
 
             case ButtonPress:
+                if (a->grid_on && e.xbutton.button != Button2) {
+                    app_grid_button(a, &e.xbutton);
+                    break;
+                }
+
                 switch (e.xbutton.button) {
                 case Button1:
                     a->mouse = (Vec2) {e.xbutton.x, e.xbutton.y};
@@ -736,6 +2503,14 @@ void app_loop(App *a) {
                 break;
 
             case MotionNotify: {
+                // Only the latest position of a burst of motion matters
+                while (XPending(a->display)) {
+                    XEvent next;
+                    XPeekEvent(a->display, &next);
+                    if (next.type != MotionNotify) break;
+                    XNextEvent(a->display, &e);
+                }
+
                 const Vec2 pos = (Vec2) {e.xmotion.x, e.xmotion.y};
                 if (a->dragging) {
                     a->final.offset = vec2_add(a->final.offset, vec2_sub(pos, a->mouse));
@@ -745,6 +2520,11 @@ void app_loop(App *a) {
             } break;
 
             case KeyPress:
+                if (a->grid_on && XLookupKeysym(&e.xkey, 0) != 'q') {
+                    app_grid_key(a, XLookupKeysym(&e.xkey, 0));
+                    break;
+                }
+
                 switch (XLookupKeysym(&e.xkey, 0)) {
                 case 'q':
                     return;
@@ -778,9 +2558,7 @@ void app_loop(App *a) {
 
                 case 'w': {
                     XImage *wallpaper = app_snap_ximage(a, (Vec2) {0}, a->size);
-                    if (a->wallpaper) {
-                        XDestroyImage(a->wallpaper);
-                    }
+                    app_wallpaper_free(a);
                     a->wallpaper = wallpaper;
                 } break;
 
@@ -822,8 +2600,39 @@ void app_loop(App *a) {
                     }
                     break;
 
+                case '.':
+                    app_orient_image(a, false, 1);
+                    break;
+
+                case ',':
+                    app_orient_image(a, false, 3);
+                    break;
+
+                case 'h':
+                    app_orient_image(a, true, 0);
+                    break;
+
+                case 'v':
+                    app_orient_image(a, true, 2);
+                    break;
+
+                case 'g':
+                    // Thumbnails are batched into a single draw call, which needs GL
+                    if (!a->use_cpu && !a->select_on) {
+                        app_grid_toggle(a);
+                    }
+                    break;
+
+                case 'l':
+                    if (a->live_on) {
+                        app_live_stop(a);
+                    } else if (a->shown != SIZE_MAX && !a->select_on) {
+                        app_live_start(a);
+                    }
+                    break;
+
                 case 'd':
-                    if (a->images.data[a->current].type) {
+                    if (image_is_file(&a->images.data[a->current])) {
                         const size_t save = a->temp.count;
 
                         const char *fullpath = a->paths.data + a->images.data[a->current].path;
@@ -844,15 +2653,53 @@ void app_loop(App *a) {
 }
 
 void app_exit(App *a) {
-    glDeleteVertexArrays(1, &a->vao);
-    glDeleteBuffers(1, &a->vbo);
-    glDeleteBuffers(1, &a->ebo);
-    glDeleteProgram(a->image_program);
-    glDeleteProgram(a->overlay_program);
-    glDeleteTextures(1, &a->texture);
+    if (a->live_on) {
+        app_live_stop(a);
+    }
+    worker_free(&a->worker, decode_free);
+    app_stop_animation(a);
+    worker_free(&a->animation_worker, animation_free);
+    worker_free(&a->cache_worker, free);
+    if (a->grid_atlas) {
+        worker_free(&a->grid_worker, thumb_free);
+    }
+
+    if (a->use_cpu) {
+        cpu_free(&a->cpu);
+    } else {
+        for (size_t i = 0; i < UPLOAD_SLICES; i++) {
+            if (a->upload_fences[i]) glDeleteSync(a->upload_fences[i]);
+        }
+
+        if (a->upload_buffer) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, a->upload_buffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glDeleteBuffers(1, &a->upload_buffer);
+        }
+        glDeleteTextures(1, &a->upload_texture);
+        glDeleteTextures(1, &a->preview_texture);
+        if (a->grid_atlas) {
+            glDeleteTextures(1, &a->grid_atlas);
+            glDeleteVertexArrays(1, &a->grid_vao);
+            glDeleteBuffers(1, &a->grid_vbo);
+            glDeleteProgram(a->grid_program);
+        }
+        for (size_t i = 0; i < a->images.count; i++) {
+            glDeleteTextures(1, &a->images.data[i].texture);
+        }
+
+        glDeleteVertexArrays(1, &a->vao);
+        glDeleteBuffers(1, &a->vbo);
+        glDeleteBuffers(1, &a->ebo);
+        glDeleteProgram(a->image_program);
+        if (a->render_adaptive) {
+            glDeleteFramebuffers(1, &a->render_fbo);
+            glDeleteTextures(1, &a->render_texture);
+        }
 
-    glXMakeCurrent(a->display, None, NULL);
-    glXDestroyContext(a->display, a->glx_context);
+        glXMakeCurrent(a->display, None, NULL);
+        glXDestroyContext(a->display, a->glx_context);
+    }
 
     XSetInputFocus(a->display, a->revert_window, a->revert_return, CurrentTime);
     XUngrabKeyboard(a->display, CurrentTime);
@@ -864,15 +2711,22 @@ void app_exit(App *a) {
     XCloseDisplay(a->display);
 
     for (size_t i = 0; i < a->images.count; i++) {
-        free(a->images.data[i].data);
+        image_free(&a->images.data[i]);
     }
+    image_free(&a->preview);
+    free(a->grid_owners);
+    da_free(&a->grid_instances);
     da_free(&a->images);
     da_free(&a->paths);
     da_free(&a->temp);
 
+    close(a->ipc_socket);
+    unlink(IPC_SOCKET_PATH);
     unlink(IPC_LOCK_FILE);
 }
 
+// Copies the wallpaper into a shared segment so the server reads it straight from memory instead
+// of the whole image going through the socket
 void app_wallpaper(App *a) {
     if (!a->wallpaper) {
         return;
@@ -889,7 +2743,17 @@ void app_wallpaper(App *a) {
     Pixmap pixmap = XCreatePixmap(display, root, width, height, a->wallpaper->depth);
     GC     gc = XCreateGC(display, root, 0, NULL);
 
-    XPutImage(display, pixmap, gc, a->wallpaper, 0, 0, 0, 0, width, height);
+    if (a->wallpaper_shm.shmaddr) {
+        // The segment is attached to the connection of the app, which can only draw into the
+        // pixmap once it exists. The server must be done reading before the segment is detached
+        XSync(display, False);
+        GC shared = XCreateGC(a->display, root, 0, NULL);
+        XShmPutImage(a->display, pixmap, shared, a->wallpaper, 0, 0, 0, 0, width, height, False);
+        XFreeGC(a->display, shared);
+        XSync(a->display, False);
+    } else {
+        XPutImage(display, pixmap, gc, a->wallpaper, 0, 0, 0, 0, width, height);
+    }
 
     {
         int  screen = DefaultScreen(display);
@@ -968,10 +2832,23 @@ void app_wallpaper(App *a) {
     XSync(display, false);
     XKillClient(display, AllTemporary);
     XSetCloseDownMode(display, RetainTemporary);
-    XDestroyImage(a->wallpaper);
+    app_wallpaper_free(a);
     XFreeGC(display, gc);
     XCloseDisplay(display);
+}
+
+void app_wallpaper_free(App *a) {
+    if (!a->wallpaper) {
+        return;
+    }
 
+    // Xlib would free the data and the segment info of the image, neither of which it allocated
+    if (a->wallpaper_shm.shmaddr) {
+        shm_detach(a->display, &a->wallpaper_shm);
+        a->wallpaper->data = NULL;
+        a->wallpaper->obdata = NULL;
+    }
+    XDestroyImage(a->wallpaper);
     a->wallpaper = NULL;
 }
 
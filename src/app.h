@@ -1,13 +1,21 @@
 #ifndef APP_H
 #define APP_H
 
+#include "config.h"
 #include "da.h"
 #include "gl.h"
 
+#include "cache.h"
 #include "camera.h"
+#include "cpu.h"
+#include "gif.h"
+#include "live.h"
 #include "shader.h"
+#include "worker.h"
 
 #include <GL/glx.h>
+#include <X11/extensions/XShm.h>
+#include <stdatomic.h>
 
 typedef struct {
     GLubyte r;
@@ -19,18 +27,90 @@ typedef struct {
 typedef enum {
     IMAGE_SCREENSHOT,
     IMAGE_FILE_QUEUED,
+    IMAGE_FILE_LOADING,
     IMAGE_FILE_LOADED,
+    IMAGE_MAPPED,
 } ImageType;
 
+typedef enum {
+    THUMB_NONE,
+    THUMB_PENDING,
+    THUMB_READY,
+    THUMB_FAILED,
+} ThumbState;
+
 typedef struct {
-    Pixel *data;
-    size_t width;
-    size_t height;
+    ThumbState state;
+    size_t     slot; // Cell of the grid atlas holding the pixels, once ready
+    size_t     width;
+    size_t     height;
+    int        orientation; // EXIF orientation, used until the image itself is decoded
+} Thumb;
+
+typedef struct {
+    uint8_t *data;
+    uint8_t *mipmaps; // Levels past the base one packed one after another, NULL if not built
+    size_t   width;
+    size_t   height;
+    size_t   channels; // Tightly packed 8 bit channels per pixel, as stored in the file
+
+    // Applied when sampling, so the pixels stay as stored
+    uint8_t rotation; // Quarter turns clockwise, after the flip
+    bool    flip;     // Mirrored horizontally
+    bool    animated; // Holds the first frame of an animated GIF
 
     ImageType type;
     size_t    path;
+
+    GLuint texture;      // Resident texture, 0 if not cached
+    size_t texture_used; // When the image was last shown, for LRU eviction
+
+    Thumb thumb;
 } Image;
 
+// Images worth making thumbnails of, shared with the threads making them so jobs which scrolled
+// out of view are dropped before doing any work
+typedef struct {
+    _Atomic size_t first;
+    _Atomic size_t last;       // Exclusive
+    _Atomic size_t generation; // Bumped whenever the indices of the images shift
+} GridRange;
+
+typedef struct {
+    float cell[4];  // Position and size in pixels
+    float image[4]; // Where the thumbnail sits within the cell, normalized to it
+    float atlas[4]; // Corners of the thumbnail in its atlas layer
+    float orientation[4];
+    float flags[2]; // Atlas layer or -1 while there is no thumbnail, and whether selected
+} GridInstance;
+
+// Playback of an animated GIF. Frames are decoded a few ahead into a ring on a worker, so the
+// memory does not depend on the amount of frames
+typedef struct {
+    size_t   path; // Identifies the image, as indices shift
+    uint8_t *file; // Mapping of the whole file, which the decoder reads from
+    size_t   size;
+    Gif     *gif;
+
+    uint8_t *frames[ANIMATION_FRAMES];
+    uint8_t *screen; // Copy of the frame on screen the CPU renderer draws, NULL until one is shown
+    int      delays[ANIMATION_FRAMES]; // In milliseconds
+    size_t   head;
+    size_t   count;
+    double   due; // When the frame at the head replaces the one on screen
+
+    // While decoding, the worker owns the decoder and the slot past the last frame in the ring
+    bool   decoding;
+    size_t decoding_slot;
+    bool   failed;
+} Animation;
+
+typedef struct {
+    int    fd; // Sealed memfd holding tightly packed RGBA pixels
+    size_t width;
+    size_t height;
+} Pixels;
+
 typedef struct {
     Display *display;
     Window   window;
@@ -41,23 +121,48 @@ typedef struct {
     GLuint     vao;
     GLuint     vbo;
     GLuint     ebo;
-    GLuint     texture;
     GLXContext glx_context;
 
+    bool use_cpu; // Whether frames are drawn by the software renderer instead of GL
+    Cpu  cpu;
+
+    // Textures of recently shown images stay resident, bounded by count and size
+    size_t texture_tick;
+    size_t texture_count;
+    size_t texture_bytes;
+    bool   texture_storage; // Whether textures can be allocated as immutable storage
+
+    // The current image is uploaded into a spare texture in slices across frames, which joins
+    // the cache once complete
+    GLuint   upload_texture;
+    GLuint   upload_buffer;
+    uint8_t *upload_map; // Persistently mapped ring of slices, NULL if unsupported
+    GLsync   upload_fences[UPLOAD_SLICES];
+    size_t   upload_slice;
+    size_t   upload_image; // SIZE_MAX when idle
+    size_t   upload_level;
+    size_t   upload_row;
+
+    GLuint render_fbo;
+    GLuint render_texture;
+    bool   render_adaptive; // Whether frames may be rendered at a reduced resolution
+    float  render_scale;    // Resolution of the next frame relative to the window
+
     GLuint image_program;
+    GLint  image_uniform_fit;
+    GLint  image_uniform_orientation;
     GLint  image_uniform_zoom;
     GLint  image_uniform_offset;
 
-    GLuint overlay_program;
-    GLint  overlay_uniform_mouse;
-    GLint  overlay_uniform_aspect;
+    GLint image_uniform_mouse;
+    GLint image_uniform_aspect;
 
-    GLint overlay_uniform_lens_size;
-    GLint overlay_uniform_lens_color;
+    GLint image_uniform_lens_size;
+    GLint image_uniform_lens_color;
 
-    GLint overlay_uniform_select_began;
-    GLint overlay_uniform_select_mouse;
-    GLint overlay_uniform_select_start;
+    GLint image_uniform_select_began;
+    GLint image_uniform_select_mouse;
+    GLint image_uniform_select_start;
 
     bool focus;
     bool dragging;
@@ -65,16 +170,51 @@ typedef struct {
     Vec2 size;
     Vec2 mouse;
 
-    Camera final;
-    Camera camera;
+    Camera     final;
+    Camera     camera;
+    CameraEase ease;
 
     size_t current;
+    size_t shown; // The image on screen, which lags behind the current one while it loads
+    Image  preview;
+    bool   preview_shown; // Whether the shown image is still drawn from its preview
+    GLuint preview_texture;
     DynamicArray(Image) images;
 
+    // Thumbnail grid, drawn from the layers of an atlas in a single instanced call. Only the
+    // rows around the visible ones hold thumbnails, so it scales to any amount of images
+    bool      grid_on;
+    size_t    grid_selected;
+    float     grid_scroll; // Pixels scrolled past the top of the first row
+    GLuint    grid_program;
+    GLint     grid_uniform_screen;
+    GLuint    grid_vao;
+    GLuint    grid_vbo;
+    GLuint    grid_atlas; // 0 until the grid is first opened
+    size_t    grid_slots;
+    size_t   *grid_owners; // Image of each atlas cell, SIZE_MAX if free
+    Worker    grid_worker;
+    size_t    grid_pending;
+    GridRange grid_range;
+    DynamicArray(GridInstance) grid_instances;
+
+    Animation *animation; // Of the shown image, NULL if it is not animated
+    Worker     animation_worker;
+
+    Worker worker;       // Decodes images off the render thread
+    Worker cache_worker; // Writes the cache entries of images once they are shown
+    Cache  cache;
+    bool   load_forward; // Which way to skip when the current image fails to decode
+
     bool recursive;
     DynamicArray(char) paths;
 
-    XImage *wallpaper; // Owned
+    XImage         *wallpaper;     // Owned
+    XShmSegmentInfo wallpaper_shm; // Holding the pixels of the wallpaper if attached
+
+    bool   live_on;    // Whether the screenshot is kept up to date with the screen
+    size_t live_image; // The screenshot being updated
+    Live   live;
 
     bool   select_on;    // Whether the selection mode is on
     bool   select_exit;  // Whether the app should immediately exit after end of selection
@@ -84,6 +224,9 @@ typedef struct {
     size_t select_snap_pending;
 
     Atom ipc_message_atom;
+    int  ipc_socket;
+
+    Pixels pixels; // Owned, viewed or sent to the main instance if width is non-zero
 
     DynamicArray(char) temp;
 } App;
@@ -94,6 +237,7 @@ void app_loop(App *a);
 void app_exit(App *a);
 
 void app_wallpaper(App *a);
+void app_wallpaper_free(App *a);
 void app_screenshot(App *a);
 
 #endif // APP_H
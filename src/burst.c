@@ -0,0 +1,178 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <sys/time.h>
+
+#include <X11/Xutil.h>
+
+#include "burst.h"
+#include "config.h"
+#include "shm.h"
+
+#include "stb_image_write.h"
+
+static int64_t burst_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void burst_encode(void *data) {
+    BurstFrame *f = data;
+
+    // Packed into RGB in place, as every pixel is read before anything is written over it
+    const XImage    *image = f->image;
+    const XRectangle all = {0, 0, image->width, image->height};
+    shm_unpack(image, all, (uint8_t *) image->data, image->width, 3);
+
+    f->failed =
+        !stbi_write_png(f->path, image->width, image->height, 3, image->data, image->width * 3);
+}
+
+static void burst_discard(void *data) {
+    (void) data;
+}
+
+bool burst_init(Burst *b, Display *display, size_t count) {
+    *b = (Burst) {
+        .display = display,
+        .root = DefaultRootWindow(display),
+    };
+
+    XWindowAttributes wa = {0};
+    XGetWindowAttributes(display, b->root, &wa);
+
+    const size_t frame_size = (size_t) wa.width * wa.height * sizeof(uint32_t);
+    size_t       slots = BURST_RING_BUDGET / frame_size;
+    if (slots < 2) slots = 2;
+    if (slots > count) slots = count;
+
+    if (!shm_attach(display, &b->shm, frame_size * slots, false)) {
+        return false;
+    }
+
+    b->frames = calloc(slots, sizeof(*b->frames));
+    if (!b->frames) {
+        fprintf(stderr, "ERROR: Could not allocate burst frames\n");
+        exit(1);
+    }
+    b->count = slots;
+
+    const int screen = DefaultScreen(display);
+    for (size_t i = 0; i < slots; i++) {
+        XImage *image = XShmCreateImage(
+            display,
+            DefaultVisual(display, screen),
+            DefaultDepth(display, screen),
+            ZPixmap,
+            NULL,
+            &b->shm,
+            wa.width,
+            wa.height);
+        if (!image) {
+            burst_free(b);
+            return false;
+        }
+
+        image->data = b->shm.shmaddr + i * frame_size;
+        b->frames[i].image = image;
+    }
+
+    // The encoder packs the pixels in place, which needs them to be at least as wide as RGB
+    const XImage *image = b->frames[0].image;
+    if (image->bits_per_pixel != 32 || image->bytes_per_line != wa.width * 4) {
+        burst_free(b);
+        return false;
+    }
+
+    // The threads lower their own priority, so the captures are not held up by them
+    b->worker.nice = BURST_ENCODE_NICE;
+    worker_init(&b->worker, BURST_ENCODE_THREADS);
+    return true;
+}
+
+// Takes back the frames the encoder is done with, first waiting for one if asked to
+static bool burst_collect(Burst *b, bool wait) {
+    if (wait) {
+        struct pollfd pfd = {.fd = b->worker.event, .events = POLLIN};
+        poll(&pfd, 1, -1);
+    }
+
+    bool        result = true;
+    BurstFrame *f;
+    while ((f = worker_pop(&b->worker))) {
+        f->busy = false;
+        if (f->failed) {
+            fprintf(stderr, "ERROR: Could not save screenshot to '%s'\n", f->path);
+            result = false;
+        }
+    }
+    return result;
+}
+
+bool burst_run(Burst *b, size_t count, size_t interval) {
+    bool result = true;
+
+    struct timeval time = {0};
+    gettimeofday(&time, NULL);
+    const long long since = time.tv_sec * 1000LL + time.tv_usec / 1000;
+
+    // Every capture is due at a fixed offset from the first, so delays do not add up
+    const int64_t start = burst_now();
+    for (size_t i = 0; i < count; i++) {
+        const int64_t         due = start + (int64_t) i * interval * 1000000;
+        const struct timespec ts = {due / 1000000000, due % 1000000000};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) continue;
+
+        BurstFrame *f = &b->frames[i % b->count];
+        if (f->busy) {
+            b->late++;
+            while (f->busy) {
+                result &= burst_collect(b, true);
+            }
+        }
+
+        if (!XShmGetImage(b->display, b->root, f->image, 0, 0, AllPlanes)) {
+            fprintf(stderr, "ERROR: Could not capture screenshot\n");
+            result = false;
+            continue;
+        }
+
+        snprintf(f->path, sizeof(f->path), "thono-%lld-%03zu.png", since, i);
+        f->busy = true;
+        f->failed = false;
+        worker_push(&b->worker, burst_encode, f);
+        result &= burst_collect(b, false);
+    }
+
+    for (size_t i = 0; i < b->count; i++) {
+        while (b->frames[i].busy) {
+            result &= burst_collect(b, true);
+        }
+    }
+
+    return result;
+}
+
+void burst_free(Burst *b) {
+    if (b->worker.threads) {
+        worker_free(&b->worker, burst_discard);
+    }
+
+    for (size_t i = 0; i < b->count; i++) {
+        if (!b->frames[i].image) continue;
+        b->frames[i].image->data = NULL;
+        XDestroyImage(b->frames[i].image);
+    }
+    free(b->frames);
+
+    if (b->shm.shmaddr) {
+        shm_detach(b->display, &b->shm);
+    }
+    *b = (Burst) {0};
+}
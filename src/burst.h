@@ -0,0 +1,42 @@
+#ifndef BURST_H
+#define BURST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
+
+#include "worker.h"
+
+typedef struct {
+    XImage *image; // Over the slot of the ring
+    char    path[64];
+    bool    busy;   // Handed to the encoder, which owns it until it comes back
+    bool    failed; // Set by the encoder
+} BurstFrame;
+
+// Screenshots taken at a fixed interval. The server writes them straight into a ring of slots in
+// one shared memory segment, and encoding happens on worker threads, so the captures keep their
+// timing as long as a slot is free. The ring is allocated up front and capped by a budget
+typedef struct {
+    Display *display;
+    Window   root;
+
+    XShmSegmentInfo shm;
+    BurstFrame     *frames;
+    size_t          count;
+
+    Worker worker;
+    size_t late; // Captures that had to wait for the encoder to free a slot
+} Burst;
+
+// Returns false without MIT-SHM or on displays without 32 bit pixels
+bool burst_init(Burst *b, Display *display, size_t count);
+
+// Takes the screenshots interval milliseconds apart and returns once all of them are saved.
+// Returns false if any could not be taken or saved
+bool burst_run(Burst *b, size_t count, size_t interval);
+void burst_free(Burst *b);
+
+#endif // BURST_H
@@ -0,0 +1,248 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "basic.h"
+#include "cache.h"
+#include "config.h"
+#include "da.h"
+
+#define CACHE_MAGIC "THN1"
+
+typedef struct {
+    char     magic[4];
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t image_width;
+    uint32_t image_height;
+    uint32_t orientation;
+} CacheHeader;
+
+typedef struct {
+    char   name[32];
+    time_t used;
+    off_t  size;
+} CacheFile;
+
+static bool cache_mkdir(const char *path) {
+    return mkdir(path, 0700) == 0 || errno == EEXIST;
+}
+
+bool cache_init(Cache *c) {
+    const char *base = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+
+    int n;
+    if (base && *base) {
+        n = snprintf(c->dir, sizeof(c->dir), "%s", base);
+    } else if (home && *home) {
+        n = snprintf(c->dir, sizeof(c->dir), "%s/.cache", home);
+    } else {
+        n = -1;
+    }
+
+    if (n < 0 || (size_t) n + sizeof("/" CACHE_DIR_NAME) > sizeof(c->dir) || !cache_mkdir(c->dir)) {
+        c->dir[0] = '\0';
+        return false;
+    }
+
+    strcat(c->dir, "/" CACHE_DIR_NAME);
+    if (!cache_mkdir(c->dir)) {
+        c->dir[0] = '\0';
+        return false;
+    }
+
+    return true;
+}
+
+// FNV-1a, which is plenty for telling apart the entries of a single user
+static uint64_t hash(uint64_t h, const void *data, size_t size) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+uint64_t cache_key(
+    const char        *path,
+    const struct stat *statbuf,
+    size_t             width,
+    size_t             height,
+    int                channels) {
+    char        buffer[PATH_MAX];
+    const char *absolute = realpath(path, buffer) ? buffer : path;
+
+    const int64_t fields[] = {
+        statbuf->st_size,
+        statbuf->st_mtim.tv_sec,
+        statbuf->st_mtim.tv_nsec,
+        width,
+        height,
+        channels,
+    };
+
+    uint64_t h = 0xcbf29ce484222325ull;
+    h = hash(h, absolute, strlen(absolute));
+    h = hash(h, fields, sizeof(fields));
+    return h;
+}
+
+static void cache_path(const Cache *c, uint64_t key, char *path) {
+    snprintf(path, PATH_MAX, "%s/%016llx", c->dir, (unsigned long long) key);
+}
+
+bool cache_exists(const Cache *c, uint64_t key) {
+    if (!*c->dir) {
+        return false;
+    }
+
+    char path[PATH_MAX];
+    cache_path(c, key, path);
+    return access(path, F_OK) == 0;
+}
+
+bool cache_load(const Cache *c, uint64_t key, CacheEntry *e) {
+    bool result = true;
+    if (!*c->dir) {
+        return false;
+    }
+
+    char path[PATH_MAX];
+    cache_path(c, key, path);
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    CacheHeader header;
+    struct stat statbuf;
+    e->data = NULL;
+    if (fstat(fd, &statbuf) < 0 || read(fd, &header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic))) {
+        return_defer(false);
+    }
+
+    const size_t size = (size_t) header.width * header.height * header.channels;
+    if (!size || header.channels > 4 || (size_t) statbuf.st_size != sizeof(header) + size) {
+        return_defer(false);
+    }
+
+    e->data = malloc(size);
+    if (!e->data || pread(fd, e->data, size, sizeof(header)) != (ssize_t) size) {
+        return_defer(false);
+    }
+
+    e->width = header.width;
+    e->height = header.height;
+    e->channels = header.channels;
+    e->image_width = header.image_width;
+    e->image_height = header.image_height;
+    e->orientation = header.orientation;
+
+    // Access times are rarely kept up to date, so the modification time tracks the last use
+    futimens(fd, NULL);
+
+defer:
+    if (!result) {
+        free(e->data);
+        e->data = NULL;
+    }
+    close(fd);
+    return result;
+}
+
+static int compare_files(const void *a, const void *b) {
+    const CacheFile *fa = a;
+    const CacheFile *fb = b;
+    return (fa->used > fb->used) - (fa->used < fb->used);
+}
+
+static void cache_evict(Cache *c) {
+    DIR *dir = opendir(c->dir);
+    if (!dir) {
+        return;
+    }
+
+    DynamicArray(CacheFile) files = {0};
+    size_t total = 0;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        struct stat statbuf;
+        if (entry->d_name[0] == '.' || strlen(entry->d_name) >= sizeof(files.data->name) ||
+            fstatat(dirfd(dir), entry->d_name, &statbuf, 0) < 0 || !S_ISREG(statbuf.st_mode)) {
+            continue;
+        }
+
+        CacheFile file = {.used = statbuf.st_mtime, .size = statbuf.st_size};
+        strcpy(file.name, entry->d_name);
+        da_append(&files, file);
+        total += statbuf.st_size;
+    }
+
+    // Evicting below the limit leaves room for a number of stores before the next scan
+    if (total > CACHE_SIZE_MAX) {
+        qsort(files.data, files.count, sizeof(*files.data), compare_files);
+        for (size_t i = 0; i < files.count && total > CACHE_SIZE_LOW; i++) {
+            if (unlinkat(dirfd(dir), files.data[i].name, 0) == 0) {
+                total -= files.data[i].size;
+            }
+        }
+    }
+
+    c->size = total;
+    c->counted = true;
+
+    da_free(&files);
+    closedir(dir);
+}
+
+void cache_store(Cache *c, uint64_t key, const CacheEntry *e) {
+    if (!*c->dir) {
+        return;
+    }
+
+    const CacheHeader header = {
+        .magic = CACHE_MAGIC,
+        .width = e->width,
+        .height = e->height,
+        .channels = e->channels,
+        .image_width = e->image_width,
+        .image_height = e->image_height,
+        .orientation = e->orientation,
+    };
+
+    // Written under a temporary name and renamed, so readers never see a partial entry
+    char temp[PATH_MAX];
+    snprintf(temp, sizeof(temp), "%s/.XXXXXX", c->dir);
+
+    const int fd = mkostemp(temp, O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+
+    const size_t size = e->width * e->height * e->channels;
+    const bool   ok = write(fd, &header, sizeof(header)) == sizeof(header) &&
+                    write(fd, e->data, size) == (ssize_t) size;
+    close(fd);
+
+    char path[PATH_MAX];
+    cache_path(c, key, path);
+    if (!ok || rename(temp, path) < 0) {
+        unlink(temp);
+        return;
+    }
+
+    const size_t stored = sizeof(header) + size;
+    if (!c->counted || atomic_fetch_add(&c->size, stored) + stored > CACHE_SIZE_MAX) {
+        cache_evict(c);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sys/stat.h>
+
+// Images scaled down to the screen, stored as raw pixels behind a small header so reading one
+// back is a single read from the page cache instead of a decode
+typedef struct {
+    uint8_t *data;
+    size_t   width;
+    size_t   height;
+    size_t   channels;
+
+    // Of the original image, so the entry can stand in for it
+    size_t image_width;
+    size_t image_height;
+    int    orientation;
+} CacheEntry;
+
+typedef struct {
+    char dir[PATH_MAX - 32]; // Empty if there is no usable cache directory, leaves room for names
+
+    // Bytes stored, kept as entries are written so the directory is only scanned once it may be
+    // over the limit, or before it was first counted
+    _Atomic size_t size;
+    _Atomic bool   counted;
+} Cache;
+
+// Creates the directory under $XDG_CACHE_HOME, returns false if it is unusable
+bool cache_init(Cache *c);
+
+// Entries are keyed by everything that would change their pixels
+uint64_t cache_key(
+    const char        *path,
+    const struct stat *statbuf,
+    size_t             width,
+    size_t             height,
+    int                channels);
+
+bool cache_exists(const Cache *c, uint64_t key);
+bool cache_load(const Cache *c, uint64_t key, CacheEntry *e);
+
+// Evicts the least recently used entries down to CACHE_SIZE_LOW once the cache grows past
+// CACHE_SIZE_MAX
+void cache_store(Cache *c, uint64_t key, const CacheEntry *e);
+
+#endif // CACHE_H
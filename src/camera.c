@@ -1,3 +1,5 @@
+#include <math.h>
+
 #include "camera.h"
 #include "config.h"
 
@@ -5,12 +7,51 @@ Vec2 camera_world(const Camera *c, Vec2 v) {
     return vec2_scale(vec2_sub(v, c->offset), 1.0 / c->zoom);
 }
 
-void camera_update(Camera *c, const Camera *final, float dt) {
-    const float ds = SPEED * dt;
-    c->lens_size += (final->lens_size - c->lens_size) * ds;
-    c->lens_color =
-        vec4_add(c->lens_color, vec4_scale(vec4_sub(final->lens_color, c->lens_color), ds));
+static bool camera_equal(const Camera *a, const Camera *b) {
+    return a->lens_size == b->lens_size && a->lens_color.x == b->lens_color.x &&
+           a->lens_color.y == b->lens_color.y && a->lens_color.z == b->lens_color.z &&
+           a->lens_color.w == b->lens_color.w && a->zoom == b->zoom &&
+           a->offset.x == b->offset.x && a->offset.y == b->offset.y;
+}
+
+static Camera camera_lerp(const Camera *a, const Camera *b, float t) {
+    return (Camera) {
+        .lens_size = a->lens_size + (b->lens_size - a->lens_size) * t,
+        .lens_color =
+            vec4_add(a->lens_color, vec4_scale(vec4_sub(b->lens_color, a->lens_color), t)),
+        .zoom = a->zoom + (b->zoom - a->zoom) * t,
+        .offset = vec2_add(a->offset, vec2_scale(vec2_sub(b->offset, a->offset), t)),
+    };
+}
+
+// Exponential ease out, normalized so that it lands exactly on the target after CAMERA_DURATION.
+// Since the velocity is proportional to the remaining distance, restarting it from the current
+// camera whenever the target changes keeps the motion smooth
+static float camera_ease(double elapsed) {
+    if (elapsed >= CAMERA_DURATION) return 1.0;
+    return (1.0 - exp(-SPEED * elapsed)) / (1.0 - exp(-SPEED * CAMERA_DURATION));
+}
+
+bool camera_update(Camera *c, CameraEase *e, const Camera *final, double now) {
+    if (!camera_equal(&e->to, final)) {
+        e->from = *c;
+        e->to = *final;
+        e->start = now;
+    }
+
+    if (camera_equal(c, final)) {
+        return false;
+    }
+
+    if (now >= camera_deadline(e)) {
+        *c = *final;
+        return true;
+    }
+
+    *c = camera_lerp(&e->from, &e->to, camera_ease(now - e->start));
+    return true;
+}
 
-    c->zoom += (final->zoom - c->zoom) * ds;
-    c->offset = vec2_add(c->offset, vec2_scale(vec2_sub(final->offset, c->offset), ds));
+double camera_deadline(const CameraEase *e) {
+    return e->start + CAMERA_DURATION;
 }
@@ -1,6 +1,8 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
+#include <stdbool.h>
+
 #include "la.h"
 
 typedef struct {
@@ -11,7 +13,17 @@ typedef struct {
     float zoom;
 } Camera;
 
+typedef struct {
+    Camera from;
+    Camera to;
+    double start;
+} CameraEase;
+
 Vec2 camera_world(const Camera *c, Vec2 v);
-void camera_update(Camera *c, const Camera *final, float dt);
+
+// Moves the camera towards the final one as a function of time only, so the motion does not depend
+// on how often it is called. Returns false once the camera has settled and nothing changed
+bool   camera_update(Camera *c, CameraEase *e, const Camera *final, double now);
+double camera_deadline(const CameraEase *e);
 
 #endif // CAMERA_H
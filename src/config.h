@@ -7,11 +7,20 @@
 #define ZOOM_FACTOR 1.1
 #define LENS_FACTOR 1.2
 
+#define CAMERA_DURATION 0.6
+
+#define RENDERER_ENV "THONO_RENDERER"
+
+#define RENDER_SCALE_MIN      0.35
+#define RENDER_SCALE_MAX      0.75
+#define RENDER_SCALE_HEADROOM 0.7
+
 #define SELECTION_COLOR  0.6, 0.6, 0.6, 1.0
 #define FLASHLIGHT_COLOR 0.0, 0.0, 0.0, 0.8
 #define BACKGROUND_COLOR (0x20 / 255.0), (0x20 / 255.0), (0x20 / 255.0), 1.0
 
 #define IPC_LOCK_FILE    "/tmp/thono.lock"
+#define IPC_SOCKET_PATH  "/tmp/thono.sock"
 #define IPC_WINDOW_NAME  "Thono"
 #define IPC_MESSAGE_LOAD "THONO_LOAD"
 
@@ -21,7 +30,46 @@
 #define IPC_TEMPORARY_FILE "/tmp/thono_lm_XXXXXX"
 
 #define WALLPAPER_RESTORE_PATH_DEFAULT ".local/share/wallpaper"
+#define WALLPAPER_PIXELS_SUFFIX        ".pixels"
+#define WALLPAPER_MONITORS_MAX         16
 
 #define SELECTION_PENDING_FRAMES_SKIP 5
 
+#define BURST_INTERVAL_DEFAULT 33
+#define BURST_RING_BUDGET      (256 << 20)
+#define BURST_ENCODE_THREADS   2
+#define BURST_ENCODE_NICE      10
+
+#define DAMAGE_RECTS_MAX 64
+
+#define RECORD_FPS_DEFAULT 30
+#define RECORD_FPS_MAX     240
+
+#define DECODE_THREADS 2
+
+#define TEXTURE_CACHE_COUNT  8
+#define TEXTURE_CACHE_BUDGET (512 << 20)
+
+#define CACHE_DIR_NAME   "thono"
+#define CACHE_SIZE_MAX   (256 << 20)
+#define CACHE_SIZE_LOW   (192 << 20)
+#define CACHE_STORE_NICE 10
+
+#define UPLOAD_SLICES     3
+#define UPLOAD_SLICE_SIZE (8 << 20)
+
+#define ANIMATION_FRAMES        4
+#define ANIMATION_DELAY_MIN     20
+#define ANIMATION_DELAY_DEFAULT 100
+
+#define GRID_THUMB_SIZE   192
+#define GRID_CELL_SIZE    208
+#define GRID_ATLAS_SIZE   2048
+#define GRID_PRELOAD_ROWS 2
+#define GRID_JOBS_MAX     32
+#define GRID_SCROLL_STEP  64
+#define GRID_BORDER_SIZE  3.0
+
+#define GRID_PLACEHOLDER_COLOR (0x30 / 255.0), (0x30 / 255.0), (0x30 / 255.0), 1.0
+
 #endif // CONFIG_H
@@ -0,0 +1,481 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <X11/Xutil.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+
+#include "cpu.h"
+#include "shm.h"
+
+#define CPU_BAND_ROWS 16
+
+// Four 16 bit lanes each holding an 8 bit channel, in R B G A order. Every lane has enough headroom
+// for a channel multiplied by a weight in [0, 256], so four channels are blended per operation
+typedef uint64_t Lanes;
+
+#define LANES_MASK 0x00FF00FF00FF00FFull
+
+static inline Lanes lanes_from_rgba(uint32_t p) {
+    return (p | ((uint64_t) p << 24)) & LANES_MASK;
+}
+
+static inline Lanes lanes_from_color(Vec4 c) {
+    const uint32_t r = c.x * 255 + 0.5;
+    const uint32_t g = c.y * 255 + 0.5;
+    const uint32_t b = c.z * 255 + 0.5;
+    const uint32_t a = c.w * 255 + 0.5;
+    return lanes_from_rgba(r | (g << 8) | (b << 16) | (a << 24));
+}
+
+// Per lane a + (b - a) * t / 256
+static inline Lanes lanes_mix(Lanes a, Lanes b, uint32_t t) {
+    return ((a * (256 - t) + b * t) >> 8) & LANES_MASK;
+}
+
+static inline uint32_t lanes_alpha(Lanes l) {
+    const uint32_t a = l >> 48;
+    return a + (a >> 7);
+}
+
+typedef struct {
+    const Cpu      *c;
+    const CpuFrame *f;
+
+    size_t width;
+    size_t height;
+
+    // Image coordinates of the first pixel and their change per pixel, see image.vs
+    double u0, du;
+    double v0, dv;
+    bool   oriented; // Whether the image is rotated or flipped, which needs sampling per pixel
+
+    Lanes    background;
+    Lanes    lens;
+    uint32_t lens_weight;
+    double   lens_radius; // In pixels
+    Vec2     mouse;       // In pixels
+
+    bool     select;
+    uint32_t select_pixel;
+    double   select_x0, select_x1;
+    double   select_y0, select_y1;
+    double   select_width; // Half the thickness of the lines, in pixels
+} Raster;
+
+// The state of sampling a single row of the image
+typedef struct {
+    const uint32_t *row0;
+    const uint32_t *row1;
+    uint32_t        fy;
+
+    size_t  start; // First and last pixel of the row inside the image
+    size_t  end;
+    int64_t u;     // Horizontal texel position of the first pixel, in 48.16 fixed point
+    int64_t du;
+    double  v;
+} Span;
+
+static inline uint32_t raster_pack(const Raster *r, Lanes l) {
+    return ((l & 0xFF) << r->c->shift_r) | (((l >> 32) & 0xFF) << r->c->shift_g) |
+           (((l >> 16) & 0xFF) << r->c->shift_b);
+}
+
+static inline Lanes raster_unpack(const Raster *r, uint32_t p) {
+    const uint32_t rgba = ((p >> r->c->shift_r) & 0xFF) | (((p >> r->c->shift_g) & 0xFF) << 8) |
+                          (((p >> r->c->shift_b) & 0xFF) << 16);
+    return lanes_from_rgba(rgba);
+}
+
+// Bilinear filtering with texel centers at half coordinates and clamping to the edges, matching
+// GL_LINEAR with GL_CLAMP_TO_EDGE
+static inline Lanes raster_sample(const Raster *r, const Span *s, int64_t u) {
+    const int64_t iw = r->f->width;
+
+    const int64_t  xf = u >> 16;
+    const uint32_t fx = (u >> 8) & 0xFF;
+    const int64_t  x0 = xf < 0 ? 0 : (xf >= iw ? iw - 1 : xf);
+    const int64_t  x1 = xf + 1 >= iw ? iw - 1 : (xf + 1 < 0 ? 0 : xf + 1);
+
+    const Lanes top = lanes_mix(lanes_from_rgba(s->row0[x0]), lanes_from_rgba(s->row0[x1]), fx);
+    const Lanes bot = lanes_mix(lanes_from_rgba(s->row1[x0]), lanes_from_rgba(s->row1[x1]), fx);
+    return lanes_mix(top, bot, s->fy);
+}
+
+#ifdef __SSE2__
+// Samples two pixels whose texels are all inside the image with 16 bit lanes, the same way as
+// raster_sample() does. Returns R G B A of the first pixel in the low half
+static inline __m128i
+raster_sample2(const Span *s, int64_t ua, int64_t ub, __m128i fy0, __m128i fy1) {
+    const __m128i zero = _mm_setzero_si128();
+    const int64_t xa = ua >> 16, xb = ub >> 16;
+    const int16_t fa = (ua >> 8) & 0xFF, fb = (ub >> 8) & 0xFF;
+
+    // Both texels of a pixel are adjacent in memory, so each row needs a single load per pixel
+    const __m128i t = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i *) (s->row0 + xa)),
+        _mm_loadl_epi64((const __m128i *) (s->row0 + xb)));
+    const __m128i b = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i *) (s->row1 + xa)),
+        _mm_loadl_epi64((const __m128i *) (s->row1 + xb)));
+
+    __m128i pa = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(t, zero), fy0),
+        _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), fy1));
+    __m128i pb = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(t, zero), fy0),
+        _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), fy1));
+
+    const __m128i wa = _mm_set_epi16(fa, fa, fa, fa, 256 - fa, 256 - fa, 256 - fa, 256 - fa);
+    const __m128i wb = _mm_set_epi16(fb, fb, fb, fb, 256 - fb, 256 - fb, 256 - fb, 256 - fb);
+    pa = _mm_mullo_epi16(_mm_srli_epi16(pa, 8), wa);
+    pb = _mm_mullo_epi16(_mm_srli_epi16(pb, 8), wb);
+    pa = _mm_add_epi16(pa, _mm_srli_si128(pa, 8));
+    pb = _mm_add_epi16(pb, _mm_srli_si128(pb, 8));
+    return _mm_srli_epi16(_mm_unpacklo_epi64(pa, pb), 8);
+}
+
+// Only the usual layouts of 32 bit TrueColor visuals, which cover practically every display
+static bool raster_simd(const Raster *r) {
+    const Cpu *c = r->c;
+    return c->shift_g == 8 && ((c->shift_r == 16 && c->shift_b == 0) ||
+                               (c->shift_r == 0 && c->shift_b == 16));
+}
+
+static size_t raster_span_simd(
+    const Raster *r, const Span *s, size_t x, size_t end, bool lens, uint32_t *out) {
+    const int64_t iw = r->f->width;
+    const __m128i k256 = _mm_set1_epi16(256);
+    const __m128i fy1 = _mm_set1_epi16(s->fy);
+    const __m128i fy0 = _mm_sub_epi16(k256, fy1);
+
+    const Lanes   bl = r->background, ll = r->lens;
+    const __m128i background = _mm_set_epi16(
+        bl >> 48, (bl >> 16) & 0xFF, (bl >> 32) & 0xFF, bl & 0xFF,
+        bl >> 48, (bl >> 16) & 0xFF, (bl >> 32) & 0xFF, bl & 0xFF);
+    const __m128i lens_weight = _mm_set1_epi16(256 - r->lens_weight);
+    const __m128i lens_color = _mm_mullo_epi16(
+        _mm_set_epi16(
+            ll >> 48, (ll >> 16) & 0xFF, (ll >> 32) & 0xFF, ll & 0xFF,
+            ll >> 48, (ll >> 16) & 0xFF, (ll >> 32) & 0xFF, ll & 0xFF),
+        _mm_set1_epi16(r->lens_weight));
+    const __m128i rgb = _mm_set1_epi32(0x00FFFFFF);
+    const bool    bgr = r->c->shift_r == 16;
+
+    const uint64_t last = iw - 1;
+    int64_t        u = s->u + (int64_t) (x - s->start) * s->du;
+    for (; x + 2 <= end; x += 2, u += 2 * s->du) {
+        const int64_t ub = u + s->du;
+        if ((uint64_t) (u >> 16) >= last || (uint64_t) (ub >> 16) >= last) {
+            break;
+        }
+
+        const __m128i p = raster_sample2(s, u, ub, fy0, fy1);
+
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, 0xFF), 0xFF);
+        alpha = _mm_add_epi16(alpha, _mm_srli_epi16(alpha, 7));
+
+        __m128i c = _mm_srli_epi16(
+            _mm_add_epi16(
+                _mm_mullo_epi16(background, _mm_sub_epi16(k256, alpha)), _mm_mullo_epi16(p, alpha)),
+            8);
+
+        if (lens) {
+            c = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c, lens_weight), lens_color), 8);
+        }
+
+        if (bgr) {
+            c = _mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 0, 1, 2));
+            c = _mm_shufflehi_epi16(c, _MM_SHUFFLE(3, 0, 1, 2));
+        }
+        _mm_storel_epi64((__m128i *) (out + x), _mm_and_si128(_mm_packus_epi16(c, c), rgb));
+    }
+
+    return x;
+}
+#endif // __SSE2__
+
+static inline uint32_t raster_pixel(const Raster *r, const Span *s, int64_t u, bool lens) {
+    const Lanes pixel = raster_sample(r, s, u);
+
+    Lanes c = lanes_mix(r->background, pixel, lanes_alpha(pixel));
+    if (lens) c = lanes_mix(c, r->lens, r->lens_weight);
+    return raster_pack(r, c);
+}
+
+// Rotated images walk the texels diagonally across a row, so every pixel gets its own rows
+static uint32_t raster_pixel_oriented(const Raster *r, const Span *s, size_t x, bool lens) {
+    const CpuFrame *f = r->f;
+    const int64_t   iw = f->width;
+    const int64_t   ih = f->height;
+
+    const double cu = r->u0 + r->du * x - 0.5;
+    const double cv = s->v - 0.5;
+    const double u = f->orientation[0] * cu + f->orientation[2] * cv + 0.5;
+    const double v = f->orientation[1] * cu + f->orientation[3] * cv + 0.5;
+
+    const int64_t ty = llround((v * ih - 0.5) * 256);
+    const int64_t yf = ty >> 8;
+    const int64_t y0 = yf < 0 ? 0 : (yf >= ih ? ih - 1 : yf);
+    const int64_t y1 = yf + 1 >= ih ? ih - 1 : (yf + 1 < 0 ? 0 : yf + 1);
+
+    const Span texel = {
+        .row0 = f->image + y0 * iw,
+        .row1 = f->image + y1 * iw,
+        .fy = ty & 0xFF,
+    };
+    return raster_pixel(r, &texel, llround((u * iw - 0.5) * 256) << 8, lens);
+}
+
+static void
+raster_span(const Raster *r, const Span *s, size_t x, size_t end, bool lens, uint32_t *out) {
+    if (r->oriented) {
+        for (; x < end; x++) out[x] = raster_pixel_oriented(r, s, x, lens);
+        return;
+    }
+
+    int64_t u = s->u + (int64_t) (x - s->start) * s->du;
+
+    // The pixels near the edges of the image get their texels clamped, so they take the slow path
+    for (; x < end && u < 0; x++, u += s->du) {
+        out[x] = raster_pixel(r, s, u, lens);
+    }
+
+#ifdef __SSE2__
+    if (raster_simd(r)) {
+        x = raster_span_simd(r, s, x, end, lens, out);
+        u = s->u + (int64_t) (x - s->start) * s->du;
+    }
+#endif // __SSE2__
+
+    for (; x < end; x++, u += s->du) {
+        out[x] = raster_pixel(r, s, u, lens);
+    }
+}
+
+// Draws the pixels in [start, end) of a row, either with or without the lens darkening
+static void raster_segment(
+    const Raster *r, const Span *s, size_t start, size_t end, bool lens, uint32_t *out) {
+    const uint32_t background =
+        raster_pack(r, lens ? lanes_mix(r->background, r->lens, r->lens_weight) : r->background);
+
+    const size_t a = s->start > start ? (s->start < end ? s->start : end) : start;
+    const size_t b = s->end < end ? (s->end > a ? s->end : a) : end;
+    for (size_t x = start; x < a; x++) out[x] = background;
+    raster_span(r, s, a, b, lens, out);
+    for (size_t x = b; x < end; x++) out[x] = background;
+}
+
+static void raster_row(const Raster *r, size_t y, uint32_t *out) {
+    const CpuFrame *f = r->f;
+
+    Span         s = {0};
+    const double v = r->v0 + r->dv * y;
+    if (f->image && v >= 0.0 && v <= 1.0) {
+        s.start = fmax(0.0, fmin(r->width, ceil(-r->u0 / r->du)));
+        s.end = fmax(0.0, fmin(r->width, floor((1.0 - r->u0) / r->du) + 1.0));
+        if (s.end < s.start) s.end = s.start;
+
+        // Rounded to the precision of the weights, so exact texel centers do not bleed over
+        const int64_t iw = f->width;
+        const int64_t ih = f->height;
+        const int64_t ty = llround((v * ih - 0.5) * 256);
+        const int64_t yf = ty >> 8;
+        const int64_t y0 = yf < 0 ? 0 : (yf >= ih ? ih - 1 : yf);
+        const int64_t y1 = yf + 1 >= ih ? ih - 1 : (yf + 1 < 0 ? 0 : yf + 1);
+
+        s.row0 = f->image + y0 * iw;
+        s.row1 = f->image + y1 * iw;
+        s.fy = ty & 0xFF;
+        s.u = llround(((r->u0 + r->du * s.start) * iw - 0.5) * 256) << 8;
+        s.du = llround(r->du * iw * 65536);
+        s.v = v;
+    }
+
+    // The lens darkens everything outside of the circle around the mouse
+    size_t ca = 0, cb = r->width;
+    if (r->lens_weight) {
+        const double dy = y + 0.5 - r->mouse.y;
+        const double dx2 = r->lens_radius * r->lens_radius - dy * dy;
+
+        ca = cb = 0;
+        if (dx2 > 0.0) {
+            const double dx = sqrt(dx2);
+            ca = fmax(0.0, fmin(r->width, ceil(r->mouse.x - dx - 0.5)));
+            cb = fmax(0.0, fmin(r->width, ceil(r->mouse.x + dx - 0.5)));
+        }
+    }
+
+    raster_segment(r, &s, 0, ca, true, out);
+    raster_segment(r, &s, ca, cb, false, out);
+    raster_segment(r, &s, cb, r->width, true, out);
+
+    if (r->select) {
+        const double py = y + 0.5;
+        const double w = r->select_width;
+        if (fabs(py - r->select_y0) < w || fabs(py - r->select_y1) < w) {
+            const size_t a = fmax(0.0, fmin(r->width, ceil(r->select_x0 - 0.5)));
+            const size_t b = fmax(0.0, fmin(r->width, floor(r->select_x1 - 0.5) + 1.0));
+            for (size_t x = a; x < b; x++) out[x] = r->select_pixel;
+        }
+
+        if (r->select_y0 <= py && py <= r->select_y1) {
+            const double edges[] = {r->select_x0, r->select_x1};
+            for (size_t i = 0; i < 2; i++) {
+                const double e = edges[i];
+                const size_t a = fmax(0.0, fmin(r->width, ceil(e - r->select_width - 0.5)));
+                const size_t b = fmax(0.0, fmin(r->width, ceil(e + r->select_width - 0.5)));
+                for (size_t x = a; x < b; x++) out[x] = r->select_pixel;
+            }
+        }
+    }
+}
+
+static void raster_band(void *data, size_t index) {
+    const Raster *r = data;
+    const XImage *image = r->c->image;
+
+    const size_t start = index * CPU_BAND_ROWS;
+    const size_t end = start + CPU_BAND_ROWS < r->height ? start + CPU_BAND_ROWS : r->height;
+    for (size_t y = start; y < end; y++) {
+        raster_row(r, y, (uint32_t *) (image->data + y * image->bytes_per_line));
+    }
+}
+
+static bool cpu_attach_shm(Cpu *c, Visual *visual, int depth, size_t width, size_t height) {
+    if (!XShmQueryExtension(c->display)) {
+        return false;
+    }
+
+    c->image = XShmCreateImage(c->display, visual, depth, ZPixmap, NULL, &c->shm, width, height);
+    if (!c->image) {
+        return false;
+    }
+
+    c->shm_attached = shm_attach(c->display, &c->shm, c->image->bytes_per_line * height, false);
+    if (!c->shm_attached) {
+        XDestroyImage(c->image);
+        c->image = NULL;
+        return false;
+    }
+
+    c->image->data = c->shm.shmaddr;
+    return true;
+}
+
+static bool mask_shift(unsigned long mask, int *shift) {
+    if (!mask) return false;
+    *shift = __builtin_ctzl(mask);
+    return (mask >> *shift) == 0xFF;
+}
+
+bool cpu_init(
+    Cpu     *c,
+    Display *display,
+    Window   window,
+    Visual  *visual,
+    int      depth,
+    size_t   width,
+    size_t   height) {
+    c->display = display;
+    c->window = window;
+
+    if (!cpu_attach_shm(c, visual, depth, width, height)) {
+        c->image = XCreateImage(display, visual, depth, ZPixmap, 0, NULL, width, height, 32, 0);
+        if (!c->image) {
+            return false;
+        }
+
+        c->image->data = malloc(c->image->bytes_per_line * height);
+        if (!c->image->data) {
+            fprintf(stderr, "ERROR: Could not allocate framebuffer\n");
+            exit(1);
+        }
+    }
+
+    // Only 8 bit channels in host order 32 bit pixels are supported, which is what every TrueColor
+    // visual in practice uses
+    const int host = *(const uint8_t *) &(uint16_t) {1} ? LSBFirst : MSBFirst;
+    if (c->image->bits_per_pixel != 32 || c->image->byte_order != host ||
+        !mask_shift(c->image->red_mask, &c->shift_r) ||
+        !mask_shift(c->image->green_mask, &c->shift_g) ||
+        !mask_shift(c->image->blue_mask, &c->shift_b)) {
+        cpu_free(c);
+        return false;
+    }
+
+    c->gc = XCreateGC(display, window, 0, NULL);
+    pool_init(&c->pool, 0);
+    return true;
+}
+
+void cpu_draw(Cpu *c, const CpuFrame *f) {
+    const size_t width = c->image->width;
+    const size_t height = c->image->height;
+
+    Raster r = {
+        .c = c,
+        .f = f,
+        .width = width,
+        .height = height,
+        .background = lanes_from_color(f->background),
+    };
+
+    // Same mapping as image.vs, evaluated at pixel centers
+    const double sx = f->fit.x * f->zoom;
+    const double sy = f->fit.y * f->zoom;
+    r.du = 1.0 / (width * sx);
+    r.u0 = ((1.0 / width - 1.0 - f->offset.x) / sx) * 0.5 + 0.5;
+    r.dv = 1.0 / (height * sy);
+    r.v0 = 0.5 - ((1.0 - 1.0 / height - f->offset.y) / sy) * 0.5;
+    r.oriented = f->orientation[0] != 1.0 || f->orientation[3] != 1.0;
+
+    if (f->lens_color.w > 0.0) {
+        r.lens = lanes_from_color(f->lens_color);
+        r.lens_weight = f->lens_color.w * 256 + 0.5;
+        r.lens_radius = f->lens_size * height;
+        r.mouse = (Vec2) {f->mouse.x * width, f->mouse.y * height};
+    }
+
+    if (f->select_began) {
+        r.select = true;
+        r.select_pixel = raster_pack(&r, lanes_from_color(f->select_color));
+        r.select_x0 = fmin(f->select_mouse.x, f->select_start.x) * width;
+        r.select_x1 = fmax(f->select_mouse.x, f->select_start.x) * width;
+        r.select_y0 = fmin(f->select_mouse.y, f->select_start.y) * height;
+        r.select_y1 = fmax(f->select_mouse.y, f->select_start.y) * height;
+        r.select_width = 0.001 * height;
+    }
+
+    pool_for(&c->pool, raster_band, &r, (height + CPU_BAND_ROWS - 1) / CPU_BAND_ROWS);
+
+    if (c->shm_attached) {
+        XShmPutImage(c->display, c->window, c->gc, c->image, 0, 0, 0, 0, width, height, False);
+    } else {
+        XPutImage(c->display, c->window, c->gc, c->image, 0, 0, 0, 0, width, height);
+    }
+
+    // The next frame must not be drawn before the server is done reading this one
+    XSync(c->display, False);
+}
+
+void cpu_free(Cpu *c) {
+    if (c->gc) {
+        XFreeGC(c->display, c->gc);
+        pool_free(&c->pool);
+    }
+
+    if (c->shm_attached) {
+        shm_detach(c->display, &c->shm);
+        c->image->data = NULL;
+    }
+
+    if (c->image) {
+        XDestroyImage(c->image);
+    }
+
+    *c = (Cpu) {0};
+}
@@ -0,0 +1,67 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
+
+#include "la.h"
+#include "pool.h"
+
+// Everything needed to draw a frame, mirroring the uniforms of image.fs
+typedef struct {
+    const uint32_t *image; // Tightly packed RGBA
+    size_t          width;
+    size_t          height;
+
+    Vec2  fit;
+    float zoom;
+    Vec2  offset; // In normalized device coordinates
+
+    // Column major matrix taking displayed image coordinates to stored ones around the center
+    float orientation[4];
+
+    Vec4 background;
+
+    Vec2  mouse; // Normalized to the window, as are all the other positions
+    float lens_size;
+    Vec4  lens_color;
+
+    bool select_began;
+    Vec2 select_mouse;
+    Vec2 select_start;
+    Vec4 select_color;
+} CpuFrame;
+
+// Software renderer drawing frames into an XImage, shared with the server through MIT-SHM when
+// possible. Used when there is no usable GL, or when it would be a software rasterizer anyway
+typedef struct {
+    Display *display;
+    Window   window;
+    GC       gc;
+
+    XImage         *image;
+    XShmSegmentInfo shm;
+    bool            shm_attached;
+
+    int shift_r;
+    int shift_g;
+    int shift_b;
+
+    Pool pool;
+} Cpu;
+
+bool cpu_init(
+    Cpu     *c,
+    Display *display,
+    Window   window,
+    Visual  *visual,
+    int      depth,
+    size_t   width,
+    size_t   height);
+void cpu_draw(Cpu *c, const CpuFrame *f);
+void cpu_free(Cpu *c);
+
+#endif // CPU_H
@@ -0,0 +1,79 @@
+#include <dlfcn.h>
+
+#include <X11/extensions/damagewire.h>
+
+#include "damage.h"
+
+static struct {
+    Bool (*query_extension)(Display *display, int *event_base, int *error_base);
+    Damage (*create)(Display *display, Drawable drawable, int level);
+    void (*destroy)(Display *display, Damage damage);
+} xdamage;
+
+bool damage_init(Display *display, int *event_type) {
+    if (!xdamage.query_extension) {
+        // Never closed, since the library hooks into the display to clean up once it is closed
+        void *library = dlopen("libXdamage.so.1", RTLD_NOW | RTLD_LOCAL);
+        if (!library) {
+            return false;
+        }
+
+        *(void **) &xdamage.create = dlsym(library, "XDamageCreate");
+        *(void **) &xdamage.destroy = dlsym(library, "XDamageDestroy");
+        *(void **) &xdamage.query_extension = dlsym(library, "XDamageQueryExtension");
+        if (!xdamage.create || !xdamage.destroy) {
+            xdamage.query_extension = NULL;
+        }
+    }
+
+    // Also registers the conversion of the events with the display
+    int event_base, error_base;
+    if (!xdamage.query_extension || !xdamage.query_extension(display, &event_base, &error_base)) {
+        return false;
+    }
+
+    *event_type = event_base + XDamageNotify;
+    return true;
+}
+
+Damage damage_create(Display *display, Drawable drawable) {
+    return xdamage.create(display, drawable, XDamageReportRawRectangles);
+}
+
+void damage_destroy(Display *display, Damage damage) {
+    xdamage.destroy(display, damage);
+}
+
+void damage_add(DamageRects *rects, int width, int height, XRectangle rect) {
+    const int x0 = rect.x > 0 ? rect.x : 0;
+    const int y0 = rect.y > 0 ? rect.y : 0;
+    const int x1 = rect.x + rect.width < width ? rect.x + rect.width : width;
+    const int y1 = rect.y + rect.height < height ? rect.y + rect.height : height;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    for (size_t i = 0; i < rects->count; i++) {
+        const XRectangle *r = &rects->data[i];
+        if (r->x <= x0 && r->y <= y0 && r->x + r->width >= x1 && r->y + r->height >= y1) {
+            return;
+        }
+    }
+
+    rect = (XRectangle) {x0, y0, x1 - x0, y1 - y0};
+    if (rects->count == DAMAGE_RECTS_MAX) {
+        int bx0 = x0, by0 = y0, bx1 = x1, by1 = y1;
+        for (size_t i = 0; i < rects->count; i++) {
+            const XRectangle *r = &rects->data[i];
+            if (r->x < bx0) bx0 = r->x;
+            if (r->y < by0) by0 = r->y;
+            if (r->x + r->width > bx1) bx1 = r->x + r->width;
+            if (r->y + r->height > by1) by1 = r->y + r->height;
+        }
+
+        rect = (XRectangle) {bx0, by0, bx1 - bx0, by1 - by0};
+        rects->count = 0;
+    }
+
+    rects->data[rects->count++] = rect;
+}
@@ -0,0 +1,46 @@
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <X11/Xlib.h>
+
+#include "config.h"
+
+typedef XID Damage;
+
+// Parts of a drawable which changed, clipped to it
+typedef struct {
+    XRectangle data[DAMAGE_RECTS_MAX];
+    size_t     count;
+} DamageRects;
+
+// As declared by Xdamage.h, the event of a damage object created by damage_create()
+typedef struct {
+    int           type;
+    unsigned long serial;
+    Bool          send_event;
+    Display      *display;
+    Drawable      drawable;
+    Damage        damage;
+    int           level;
+    Bool          more; // More events follow for the same damage
+    Time          timestamp;
+    XRectangle    area; // Relative to the drawable
+    XRectangle    geometry;
+} DamageNotifyEvent;
+
+// Loads XDamage at runtime, so only the library is needed and not its development headers. Sets
+// the type of damage events, and returns false if the library or the extension is missing
+bool damage_init(Display *display, int *event_type);
+
+// Reports every rectangle drawn to the drawable and its inferiors as an event of its own
+Damage damage_create(Display *display, Drawable drawable);
+void   damage_destroy(Display *display, Damage damage);
+
+// Adds the rectangle clipped to the drawable of the given size, unless it is already covered. Too
+// many scattered changes are merged into the one rectangle around all of them
+void damage_add(DamageRects *rects, int width, int height, XRectangle rect);
+
+#endif // DAMAGE_H
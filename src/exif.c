@@ -0,0 +1,123 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "exif.h"
+
+#define EXIF_TAG_ORIENTATION      0x0112
+#define EXIF_TAG_THUMBNAIL_OFFSET 0x0201
+#define EXIF_TAG_THUMBNAIL_SIZE   0x0202
+
+typedef struct {
+    const uint8_t *data;
+    size_t         size;
+    bool           big_endian;
+} Tiff;
+
+static uint16_t tiff_u16(const Tiff *t, size_t offset) {
+    const uint8_t *p = t->data + offset;
+    return t->big_endian ? (p[0] << 8) | p[1] : (p[1] << 8) | p[0];
+}
+
+static uint32_t tiff_u32(const Tiff *t, size_t offset) {
+    const uint8_t *p = t->data + offset;
+    if (t->big_endian) {
+        return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+    return ((uint32_t) p[3] << 24) | (p[2] << 16) | (p[1] << 8) | p[0];
+}
+
+// Returns the offset of the next directory, or zero if there is none
+static size_t tiff_parse_ifd(const Tiff *t, size_t ifd, Exif *exif) {
+    if (ifd < 8 || ifd > t->size - 2) {
+        return 0;
+    }
+
+    size_t       thumbnail = 0, thumbnail_size = 0;
+    const size_t count = tiff_u16(t, ifd);
+    for (size_t i = 0; i < count; i++) {
+        const size_t entry = ifd + 2 + i * 12;
+        if (entry > t->size - 12) {
+            return 0;
+        }
+
+        // Short and long values are stored inline at the start of the value field
+        switch (tiff_u16(t, entry)) {
+        case EXIF_TAG_ORIENTATION: {
+            const int orientation = tiff_u16(t, entry + 8);
+            if (orientation >= 1 && orientation <= 8) {
+                exif->orientation = orientation;
+            }
+        } break;
+
+        case EXIF_TAG_THUMBNAIL_OFFSET:
+            thumbnail = tiff_u32(t, entry + 8);
+            break;
+
+        case EXIF_TAG_THUMBNAIL_SIZE:
+            thumbnail_size = tiff_u32(t, entry + 8);
+            break;
+        }
+    }
+
+    if (thumbnail && thumbnail_size && thumbnail < t->size &&
+        thumbnail_size <= t->size - thumbnail) {
+        exif->thumbnail = t->data + thumbnail;
+        exif->thumbnail_size = thumbnail_size;
+    }
+
+    const size_t next = ifd + 2 + count * 12;
+    return next <= t->size - 4 ? tiff_u32(t, next) : 0;
+}
+
+// The first directory describes the image itself, and the second one its thumbnail. The data must
+// hold at least the 8 byte header
+static void tiff_parse(const Tiff *t, Exif *exif) {
+    if (tiff_u16(t, 2) != 42) {
+        return;
+    }
+
+    const size_t next = tiff_parse_ifd(t, tiff_u32(t, 4), exif);
+    if (next) {
+        // Only the orientation of the image itself matters
+        const int orientation = exif->orientation;
+        tiff_parse_ifd(t, next, exif);
+        exif->orientation = orientation;
+    }
+}
+
+Exif exif_parse(const uint8_t *data, size_t size) {
+    Exif exif = {.orientation = 1};
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return exif;
+    }
+
+    size_t at = 2;
+    while (at + 4 <= size && data[at] == 0xFF) {
+        const uint8_t marker = data[at + 1];
+        const size_t  length = (data[at + 2] << 8) | data[at + 3];
+        if (length < 2 || at + 2 + length > size) {
+            break;
+        }
+
+        // The metadata always precedes the image data, so there is no point in going further
+        if (marker == 0xDA) {
+            break;
+        }
+
+        const uint8_t *segment = data + at + 4;
+        const size_t   segment_size = length - 2;
+        if (marker == 0xE1 && segment_size >= 6 + 8 && !memcmp(segment, "Exif\0\0", 6)) {
+            const Tiff tiff = {
+                .data = segment + 6,
+                .size = segment_size - 6,
+                .big_endian = segment[6] == 'M',
+            };
+            tiff_parse(&tiff, &exif);
+            break;
+        }
+
+        at += 2 + length;
+    }
+
+    return exif;
+}
@@ -0,0 +1,19 @@
+#ifndef EXIF_H
+#define EXIF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    int orientation; // As defined by the TIFF specification, 1 if not present
+
+    // The embedded JPEG preview, pointing into the parsed data. NULL if not present
+    const uint8_t *thumbnail;
+    size_t         thumbnail_size;
+} Exif;
+
+// Reads the metadata stored in the APP1 segment of a JPEG file. Anything which is not a JPEG or
+// has malformed metadata just gets the defaults
+Exif exif_parse(const uint8_t *data, size_t size);
+
+#endif // EXIF_H
@@ -0,0 +1,149 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "gif.h"
+
+// The GIF decoder of stb_image can only be driven a frame at a time from the inside, so a private
+// copy of it is compiled into this file, along with plenty of functions which go unused
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#define STBI_ONLY_GIF
+#define STBI_NO_STDIO
+#include "stb_image.h"
+
+struct Gif {
+    const uint8_t *data;
+    size_t         size;
+    size_t         width;
+    size_t         height;
+
+    stbi__context context;
+    stbi__gif     state;
+
+    // Composited frames before the current one, which the "restore to previous" disposal goes
+    // back to
+    uint8_t *previous;
+    uint8_t *before;
+    size_t   decoded;
+};
+
+bool gif_is_animated(const uint8_t *data, size_t size) {
+    if (size < 13 || memcmp(data, "GIF8", 4)) {
+        return false;
+    }
+
+    // Header, logical screen descriptor and global color table
+    size_t at = 13;
+    if (data[10] & 0x80) at += 3 << ((data[10] & 0x07) + 1);
+
+    size_t frames = 0;
+    while (at < size) {
+        switch (data[at++]) {
+        case 0x21: // Extension, followed by its label
+            at++;
+            break;
+
+        case 0x2C: // Image descriptor, followed by the local color table and the LZW code size
+            if (++frames > 1) return true;
+            if (at + 9 > size) return false;
+
+            const uint8_t flags = data[at + 8];
+            at += 9;
+            if (flags & 0x80) at += 3 << ((flags & 0x07) + 1);
+            at++;
+            break;
+
+        default:
+            return false;
+        }
+
+        // Sub-blocks prefixed with their size, up to an empty one
+        while (at < size && data[at]) at += data[at] + 1;
+        at++;
+    }
+
+    return false;
+}
+
+static void gif_rewind(Gif *g) {
+    STBI_FREE(g->state.out);
+    STBI_FREE(g->state.background);
+    STBI_FREE(g->state.history);
+    memset(&g->state, 0, sizeof(g->state));
+
+    stbi__start_mem(&g->context, g->data, g->size);
+    g->decoded = 0;
+}
+
+Gif *gif_open(const uint8_t *data, size_t size) {
+    Gif *g = calloc(1, sizeof(*g));
+    if (!g) {
+        return NULL;
+    }
+
+    g->data = data;
+    g->size = size;
+
+    int width, height;
+    stbi__start_mem(&g->context, data, size);
+    if (!stbi__gif_info_raw(&g->context, &width, &height, NULL) || !width || !height) {
+        free(g);
+        return NULL;
+    }
+
+    g->width = width;
+    g->height = height;
+    g->previous = malloc(g->width * g->height * 4);
+    g->before = malloc(g->width * g->height * 4);
+    if (!g->previous || !g->before) {
+        gif_close(g);
+        return NULL;
+    }
+
+    gif_rewind(g);
+    return g;
+}
+
+void gif_close(Gif *g) {
+    STBI_FREE(g->state.out);
+    STBI_FREE(g->state.background);
+    STBI_FREE(g->state.history);
+    free(g->previous);
+    free(g->before);
+    free(g);
+}
+
+void gif_size(const Gif *g, size_t *width, size_t *height) {
+    *width = g->width;
+    *height = g->height;
+}
+
+bool gif_next(Gif *g, uint8_t *pixels, int *delay) {
+    const uint8_t *two_back = g->decoded >= 2 ? g->before : NULL;
+
+    int      comp;
+    uint8_t *frame = stbi__gif_load_next(&g->context, &g->state, &comp, 4, (uint8_t *) two_back);
+    if (frame == (uint8_t *) &g->context) {
+        // Past the last frame, which can only loop if there was any frame at all
+        if (!g->decoded) return false;
+        gif_rewind(g);
+        frame = stbi__gif_load_next(&g->context, &g->state, &comp, 4, NULL);
+    }
+
+    if (!frame || frame == (uint8_t *) &g->context) {
+        return false;
+    }
+
+    const size_t size = g->width * g->height * 4;
+    memcpy(pixels, frame, size);
+    *delay = g->state.delay;
+
+    uint8_t *oldest = g->before;
+    g->before = g->previous;
+    g->previous = oldest;
+    memcpy(g->previous, frame, size);
+    g->decoded++;
+    return true;
+}
@@ -0,0 +1,28 @@
+#ifndef GIF_H
+#define GIF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming decoder of animated GIFs. Frames are decoded one at a time, and only the ones needed
+// to dispose of the previous frame are kept around, so the memory does not depend on the amount
+// of frames
+typedef struct Gif Gif;
+
+// Whether the data is a GIF with more than a single frame. Only walks the blocks of the file
+// without decoding any of them
+bool gif_is_animated(const uint8_t *data, size_t size);
+
+// The data is not copied, so it has to outlive the decoder. Returns NULL if it is not a GIF
+Gif *gif_open(const uint8_t *data, size_t size);
+void gif_close(Gif *g);
+
+// Size of the frames, which are always tightly packed RGBA
+void gif_size(const Gif *g, size_t *width, size_t *height);
+
+// Decodes the next frame into the pixels along with its delay in milliseconds, starting over from
+// the first frame after the last one. Returns false if the data is malformed
+bool gif_next(Gif *g, uint8_t *pixels, int *delay);
+
+#endif // GIF_H
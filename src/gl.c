@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "gl.h"
 
@@ -51,3 +52,20 @@ GLuint compile_program(const char *vs_source, const char *fs_source) {
     glDeleteShader(fs);
     return program;
 }
+
+bool gl_has_extension(const char *name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        if (!strcmp((const char *) glGetStringi(GL_EXTENSIONS, i), name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool gl_is_software(void) {
+    const char *renderer = (const char *) glGetString(GL_RENDERER);
+    return renderer && (strstr(renderer, "llvmpipe") || strstr(renderer, "softpipe") ||
+                        strstr(renderer, "Software Rasterizer"));
+}
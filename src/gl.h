@@ -1,6 +1,8 @@
 #ifndef GL_H
 #define GL_H
 
+#include <stdbool.h>
+
 #define GL_GLEXT_PROTOTYPES
 #include <GL/gl.h>
 #include <GL/glext.h>
@@ -9,4 +11,9 @@ GLint  get_uniform(GLuint program, const char *name);
 GLuint compile_shader(const char *source, GLenum type);
 GLuint compile_program(const char *vs_source, const char *fs_source);
 
+bool gl_has_extension(const char *name);
+
+// Whether the current context is a software rasterizer, which is slower than drawing on the CPU
+bool gl_is_software(void);
+
 #endif // GL_H
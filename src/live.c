@@ -0,0 +1,324 @@
+#include <stdio.h>
+
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+#include "live.h"
+#include "shm.h"
+
+static bool live_failed;
+
+// Windows can go away at any moment between learning about them and reading from them
+static int live_error_handler(Display *display, XErrorEvent *e) {
+    (void) display;
+    (void) e;
+    live_failed = true;
+    return 0;
+}
+
+static LiveWindow *live_find(Live *l, Window window) {
+    for (size_t i = 0; i < l->windows.count; i++) {
+        if (l->windows.data[i].window == window) return &l->windows.data[i];
+    }
+    return NULL;
+}
+
+static void live_damage(Live *l, int x, int y, int width, int height) {
+    damage_add(&l->pending, l->width, l->height, (XRectangle) {x, y, width, height});
+}
+
+static void live_damage_window(Live *l, const LiveWindow *w) {
+    if (w) live_damage(l, w->x, w->y, w->width, w->height);
+}
+
+// Takes the stacking order anew, tracking the damage of the windows which became visible and
+// dropping it for the ones which are gone
+static void live_refresh(Live *l) {
+    Window   root, parent, *children = NULL;
+    unsigned count = 0;
+    if (!XQueryTree(l->display, l->root, &root, &parent, &children, &count)) {
+        return;
+    }
+
+    DynamicArray(LiveWindow) windows = {0};
+    for (unsigned i = 0; i < count; i++) {
+        XWindowAttributes wa;
+        if (children[i] == l->ignore || !XGetWindowAttributes(l->display, children[i], &wa) ||
+            wa.map_state != IsViewable || wa.class != InputOutput) {
+            continue;
+        }
+
+        LiveWindow w = {
+            .window = children[i],
+            .x = wa.x + wa.border_width,
+            .y = wa.y + wa.border_width,
+            .width = wa.width,
+            .height = wa.height,
+            .depth = wa.depth,
+            .visual = wa.visual,
+            .above = i ? children[i - 1] : None,
+        };
+
+        LiveWindow *old = live_find(l, children[i]);
+        if (old) {
+            w.damage = old->damage;
+            old->damage = None;
+        } else {
+            w.damage = damage_create(l->display, children[i]);
+        }
+        da_append(&windows, w);
+    }
+
+    for (size_t i = 0; i < l->windows.count; i++) {
+        if (l->windows.data[i].damage) damage_destroy(l->display, l->windows.data[i].damage);
+    }
+    da_free(&l->windows);
+
+    l->windows.data = windows.data;
+    l->windows.count = windows.count;
+    l->windows.capacity = windows.capacity;
+    if (children) XFree(children);
+}
+
+bool live_start(Live *l, Display *display, Window ignore, int width, int height) {
+    *l = (Live) {
+        .display = display,
+        .root = DefaultRootWindow(display),
+        .ignore = ignore,
+        .width = width,
+        .height = height,
+    };
+
+    // Covered windows are only kept around when a compositing manager redirects them
+    char name[32];
+    snprintf(name, sizeof(name), "_NET_WM_CM_S%d", DefaultScreen(display));
+    if (XGetSelectionOwner(display, XInternAtom(display, name, False)) == None) {
+        return false;
+    }
+
+    if (!damage_init(display, &l->damage_event) ||
+        !shm_attach(display, &l->shm, (size_t) width * height * sizeof(uint32_t), false)) {
+        return false;
+    }
+
+    {
+        Atom           type;
+        int            format;
+        unsigned long  length, after;
+        unsigned char *data = NULL;
+
+        const Atom atom = XInternAtom(display, "_XROOTPMAP_ID", True);
+        if (atom != None &&
+            XGetWindowProperty(
+                display,
+                l->root,
+                atom,
+                0L,
+                1L,
+                False,
+                XA_PIXMAP,
+                &type,
+                &format,
+                &length,
+                &after,
+                &data) == Success &&
+            data && length == 1) {
+            Window       root;
+            int          x, y;
+            unsigned int w, h, border, depth;
+
+            const Pixmap pixmap = *(Pixmap *) data;
+            if (XGetGeometry(display, pixmap, &root, &x, &y, &w, &h, &border, &depth) &&
+                (int) depth == DefaultDepth(display, DefaultScreen(display))) {
+                l->background = pixmap;
+                l->background_width = w;
+                l->background_height = h;
+            }
+        }
+
+        if (data) XFree(data);
+    }
+
+    int (*handler)(Display *, XErrorEvent *) = XSetErrorHandler(live_error_handler);
+    live_refresh(l);
+    XSync(display, False);
+    XSetErrorHandler(handler);
+
+    // Whatever happened since the screenshot was taken
+    live_damage(l, 0, 0, width, height);
+    return true;
+}
+
+void live_stop(Live *l) {
+    int (*handler)(Display *, XErrorEvent *) = XSetErrorHandler(live_error_handler);
+    for (size_t i = 0; i < l->windows.count; i++) {
+        damage_destroy(l->display, l->windows.data[i].damage);
+    }
+    XSync(l->display, False);
+    XSetErrorHandler(handler);
+
+    shm_detach(l->display, &l->shm);
+    da_free(&l->windows);
+    *l = (Live) {0};
+}
+
+void live_event(Live *l, const XEvent *e) {
+    if (e->type == l->damage_event) {
+        const DamageNotifyEvent *d = (const DamageNotifyEvent *) e;
+        const LiveWindow        *w = live_find(l, d->drawable);
+        if (w) live_damage(l, w->x + d->area.x, w->y + d->area.y, d->area.width, d->area.height);
+        return;
+    }
+
+    Window window;
+    switch (e->type) {
+    case MapNotify:
+        window = e->xmap.window;
+        break;
+
+    case UnmapNotify:
+        window = e->xunmap.window;
+        break;
+
+    case ConfigureNotify:
+        window = e->xconfigure.window;
+        break;
+
+    case DestroyNotify:
+        window = e->xdestroywindow.window;
+        break;
+
+    case CirculateNotify:
+        window = e->xcirculate.window;
+        break;
+
+    default:
+        return;
+    }
+
+    if (window == l->ignore) {
+        return;
+    }
+
+    // Moving and resizing is told apart from restacking by the sibling below staying the same,
+    // which spares querying every window for each step of a drag
+    if (e->type == ConfigureNotify) {
+        LiveWindow *w = live_find(l, window);
+        if (!w) return;
+
+        const XConfigureEvent *c = &e->xconfigure;
+        if (c->above == w->above) {
+            live_damage_window(l, w);
+            w->x = c->x + c->border_width;
+            w->y = c->y + c->border_width;
+            w->width = c->width;
+            w->height = c->height;
+            live_damage_window(l, w);
+            return;
+        }
+    }
+
+    // Both where the window was and where it is now have changed
+    int (*handler)(Display *, XErrorEvent *) = XSetErrorHandler(live_error_handler);
+    live_damage_window(l, live_find(l, window));
+    live_refresh(l);
+    live_damage_window(l, live_find(l, window));
+    XSync(l->display, False);
+    XSetErrorHandler(handler);
+}
+
+// Reads the rectangle of the drawable, whose origin is at the given position on the screen, into
+// the pixels
+static void live_capture(
+    Live      *l,
+    Drawable   drawable,
+    Visual    *visual,
+    int        depth,
+    int        origin_x,
+    int        origin_y,
+    XRectangle rect,
+    uint8_t   *pixels,
+    size_t     channels) {
+    XImage *image = XShmCreateImage(
+        l->display, visual, depth, ZPixmap, l->shm.shmaddr, &l->shm, rect.width, rect.height);
+    if (!image) {
+        return;
+    }
+
+    live_failed = false;
+    const int left = rect.x - origin_x;
+    const int top = rect.y - origin_y;
+    if (XShmGetImage(l->display, drawable, image, left, top, AllPlanes) && !live_failed) {
+        const XRectangle all = {0, 0, rect.width, rect.height};
+        uint8_t         *it = &pixels[(rect.y * l->width + rect.x) * channels];
+        shm_unpack(image, all, it, l->width, channels);
+    }
+
+    image->data = NULL;
+    XDestroyImage(image);
+}
+
+static bool live_intersect(XRectangle *r, int x, int y, int width, int height) {
+    const int x0 = r->x > x ? r->x : x;
+    const int y0 = r->y > y ? r->y : y;
+    const int x1 = r->x + r->width < x + width ? r->x + r->width : x + width;
+    const int y1 = r->y + r->height < y + height ? r->y + r->height : y + height;
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+
+    *r = (XRectangle) {x0, y0, x1 - x0, y1 - y0};
+    return true;
+}
+
+size_t live_update(Live *l, uint8_t *pixels, size_t channels) {
+    const size_t count = l->pending.count;
+    if (!count) {
+        return 0;
+    }
+
+    const int screen = DefaultScreen(l->display);
+    int (*handler)(Display *, XErrorEvent *) = XSetErrorHandler(live_error_handler);
+    for (size_t i = 0; i < count; i++) {
+        const XRectangle rect = l->pending.data[i];
+
+        // The background is cleared first, so anything no window covers does not keep old pixels
+        for (int y = 0; y < rect.height; y++) {
+            uint8_t *it = &pixels[((rect.y + y) * l->width + rect.x) * channels];
+            for (int x = 0; x < rect.width; x++, it += channels) {
+                it[0] = it[1] = it[2] = 0;
+                if (channels == 4) it[3] = 0xFF;
+            }
+        }
+
+        XRectangle part = rect;
+        if (l->background &&
+            live_intersect(&part, 0, 0, l->background_width, l->background_height)) {
+            live_capture(
+                l,
+                l->background,
+                DefaultVisual(l->display, screen),
+                DefaultDepth(l->display, screen),
+                0,
+                0,
+                part,
+                pixels,
+                channels);
+        }
+
+        // Painted from the bottom up, so whatever is on top ends up in the pixels
+        for (size_t j = 0; j < l->windows.count; j++) {
+            const LiveWindow *w = &l->windows.data[j];
+            part = rect;
+            if (live_intersect(&part, w->x, w->y, w->width, w->height)) {
+                live_capture(l, w->window, w->visual, w->depth, w->x, w->y, part, pixels, channels);
+            }
+        }
+
+        l->updated[i] = rect;
+    }
+    XSetErrorHandler(handler);
+
+    l->pending.count = 0;
+    return count;
+}
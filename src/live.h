@@ -0,0 +1,62 @@
+#ifndef LIVE_H
+#define LIVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
+
+#include "config.h"
+#include "da.h"
+#include "damage.h"
+
+typedef struct {
+    Window  window;
+    int     x; // Of the contents, inside the border
+    int     y;
+    int     width;
+    int     height;
+    int     depth;
+    Visual *visual;
+    Damage  damage;
+    Window  above; // The sibling right below, viewable or not, None at the bottom
+} LiveWindow;
+
+// Keeps a copy of the screen up to date underneath a window covering it. Only what changed is
+// captured again, by painting the top level windows overlapping it from the bottom up, read from
+// the pixmaps the compositing manager keeps them in. Without a compositing manager there is
+// nothing to read the covered windows from
+typedef struct {
+    Display *display;
+    Window   root;
+    Window   ignore; // The window covering the screen
+    int      width;
+    int      height;
+    int      damage_event;
+
+    XShmSegmentInfo shm;
+
+    Pixmap background; // Set by the wallpaper setter, None if there is none
+    int    background_width;
+    int    background_height;
+
+    DynamicArray(LiveWindow) windows; // Stacked from the bottom up
+
+    DamageRects pending;
+    XRectangle  updated[DAMAGE_RECTS_MAX]; // Captured by the last live_update()
+} Live;
+
+// Returns false if XDamage, MIT-SHM or a compositing manager is missing
+bool live_start(Live *l, Display *display, Window ignore, int width, int height);
+void live_stop(Live *l);
+
+// Collects the damage and the changes of the stacking carried by the event
+void live_event(Live *l, const XEvent *e);
+
+// Captures everything that changed since the last update into the tightly packed pixels, with 3
+// or 4 channels. Returns the amount of rectangles stored in updated
+size_t live_update(Live *l, uint8_t *pixels, size_t channels);
+
+#endif // LIVE_H
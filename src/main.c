@@ -1,17 +1,25 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 
 #include "app.h"
 #include "basic.h"
+#include "burst.h"
 #include "config.h"
+#include "monitor.h"
+#include "record.h"
+#include "resize.h"
+#include "resize_gl.h"
+#include "shm.h"
 
 #include "stb_image.h"
-#include "stb_image_resize2.h"
 
 static void usage(FILE *f) {
     fprintf(f, "Usage:\n");
@@ -19,14 +27,20 @@ static void usage(FILE *f) {
     fprintf(f, "Flags:\n");
     fprintf(f, "  -h\n");
     fprintf(f, "    Show this help message.\n\n");
-    fprintf(f, "  -w <image>\n");
-    fprintf(f, "    Set the image as wallpaper.\n\n");
+    fprintf(f, "  -w <image> [pixels]\n");
+    fprintf(f, "    Set the image as wallpaper on each monitor, reusing or storing pixels.\n\n");
     fprintf(f, "  -W <image> <script>\n");
     fprintf(f, "    Set the image as wallpaper and create a restore script.\n\n");
-    fprintf(f, "  -s [delay]\n");
-    fprintf(f, "    Take a screenshot and exit, with optional delay.\n\n");
+    fprintf(f, "  -m <mode> -w|-W ...\n");
+    fprintf(f, "    Place the wallpaper with stretch (default), fill, fit, center or tile.\n\n");
+    fprintf(f, "  -s [delay] [--burst <count>] [--interval <ms>]\n");
+    fprintf(f, "    Take a screenshot, or a burst of them, and exit, with optional delay.\n\n");
     fprintf(f, "  -r [delay]\n");
     fprintf(f, "    Select a region, screenshot and exit, with optional delay.\n\n");
+    fprintf(f, "  -v [fps] [WxH+X+Y] [output]\n");
+    fprintf(f, "    Record the screen as Y4M to stdout, or a file as RGB unless it is .y4m.\n\n");
+    fprintf(f, "  -p <width> <height>\n");
+    fprintf(f, "    View raw RGBA pixels read from stdin, in the running instance if any.\n\n");
     fprintf(f, "  -R\n");
     fprintf(f, "    Open images recursively in the image viewer.\n\n");
     fprintf(f, "Paths:\n");
@@ -34,13 +48,397 @@ static void usage(FILE *f) {
     fprintf(f, "  Otherwise it takes a screenshot of the screen and views that.\n");
 }
 
-static int wallpaper(App *a, const char *path) {
+// Byte of a 32 bit pixel in memory which holds the 8 bit channel of the mask, -1 if none does
+static int ximage_channel_byte(const XImage *image, unsigned long mask) {
+    if (!mask) return -1;
+
+    const int shift = __builtin_ctzl(mask);
+    if (shift % 8 || (mask >> shift) != 0xFF || shift > 24) return -1;
+    return image->byte_order == LSBFirst ? shift / 8 : 3 - shift / 8;
+}
+
+// The layout of the resizer matching the pixels of the XImage, so it can resize straight into them
+static bool ximage_pixel_layout(const XImage *image, stbir_pixel_layout *layout) {
+    static const struct {
+        int                r, g, b;
+        stbir_pixel_layout layout;
+    } layouts[] = {
+        {0, 1, 2, STBIR_RGBA},
+        {2, 1, 0, STBIR_BGRA},
+        {1, 2, 3, STBIR_ARGB},
+        {3, 2, 1, STBIR_ABGR},
+    };
+
+    if (image->bits_per_pixel != 32) {
+        return false;
+    }
+
+    const int r = ximage_channel_byte(image, image->red_mask);
+    const int g = ximage_channel_byte(image, image->green_mask);
+    const int b = ximage_channel_byte(image, image->blue_mask);
+    for (size_t i = 0; i < sizeof(layouts) / sizeof(*layouts); i++) {
+        if (layouts[i].r == r && layouts[i].g == g && layouts[i].b == b) {
+            *layout = layouts[i].layout;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// How the image is placed on every monitor
+typedef enum {
+    WALLPAPER_STRETCH, // Resized to the monitor, ignoring the aspect ratio
+    WALLPAPER_FILL,    // Resized to cover the monitor, cropping what is left over
+    WALLPAPER_FIT,     // Resized to fit inside the monitor, with black bars around it
+    WALLPAPER_CENTER,  // Centered on the monitor as is
+    WALLPAPER_TILE,    // Repeated across the monitor as is
+} WallpaperMode;
+
+static const char *wallpaper_mode_names[] = {
+    [WALLPAPER_STRETCH] = "stretch",
+    [WALLPAPER_FILL] = "fill",
+    [WALLPAPER_FIT] = "fit",
+    [WALLPAPER_CENTER] = "center",
+    [WALLPAPER_TILE] = "tile",
+};
+
+static bool wallpaper_parse_mode(const char *s, WallpaperMode *mode) {
+    for (size_t i = 0; i < sizeof(wallpaper_mode_names) / sizeof(*wallpaper_mode_names); i++) {
+        if (!strcmp(s, wallpaper_mode_names[i])) {
+            *mode = i;
+            return true;
+        }
+    }
+
+    fprintf(stderr, "ERROR: Invalid wallpaper mode '%s'\n", s);
+    return false;
+}
+
+// Header of the wallpaper pixels stored by an earlier run, which are followed by the rows of the
+// XImage exactly as the server expects them
+typedef struct {
+    char     magic[8];
+    uint64_t source_device;
+    uint64_t source_inode;
+    uint64_t source_size;
+    int64_t  source_mtime_sec;
+    int64_t  source_mtime_nsec;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t bits_per_pixel;
+    uint32_t bytes_per_line;
+    uint32_t byte_order;
+    uint64_t red_mask;
+    uint64_t green_mask;
+    uint64_t blue_mask;
+    uint64_t monitors; // Hash of the monitor rectangles
+    uint64_t mode;
+} WallpaperPixels;
+
+#define WALLPAPER_PIXELS_MAGIC "THONOWP3"
+
+typedef struct {
+    Monitor data[WALLPAPER_MONITORS_MAX];
+    size_t  count;
+} WallpaperMonitors;
+
+static uint64_t wallpaper_monitors_hash(const WallpaperMonitors *m) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < m->count; i++) {
+        const uint64_t values[] = {m->data[i].x, m->data[i].y, m->data[i].width, m->data[i].height};
+        for (size_t j = 0; j < sizeof(values) / sizeof(*values); j++) {
+            hash = (hash ^ values[j]) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+static WallpaperPixels wallpaper_pixels_header(
+    const XImage            *image,
+    const WallpaperMonitors *monitors,
+    WallpaperMode            mode,
+    const struct stat       *source) {
+    WallpaperPixels header = {
+        .source_device = source->st_dev,
+        .source_inode = source->st_ino,
+        .source_size = source->st_size,
+        .source_mtime_sec = source->st_mtim.tv_sec,
+        .source_mtime_nsec = source->st_mtim.tv_nsec,
+        .width = image->width,
+        .height = image->height,
+        .depth = image->depth,
+        .bits_per_pixel = image->bits_per_pixel,
+        .bytes_per_line = image->bytes_per_line,
+        .byte_order = image->byte_order,
+        .red_mask = image->red_mask,
+        .green_mask = image->green_mask,
+        .blue_mask = image->blue_mask,
+        .monitors = wallpaper_monitors_hash(monitors),
+        .mode = mode,
+    };
+    memcpy(header.magic, WALLPAPER_PIXELS_MAGIC, sizeof(header.magic));
+    return header;
+}
+
+// Reads the stored pixels into the XImage, as long as they were made from the same version of the
+// image in the same mode for the same monitors and visual. The pixels are left zeroed otherwise
+static bool wallpaper_load_pixels(
+    XImage                  *image,
+    const WallpaperMonitors *monitors,
+    WallpaperMode            mode,
+    const char              *path,
+    const struct stat       *source) {
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    const WallpaperPixels expected = wallpaper_pixels_header(image, monitors, mode, source);
+    const size_t          size = (size_t) image->bytes_per_line * image->height;
+
+    bool            result = false;
+    struct stat     statbuf = {0};
+    WallpaperPixels header;
+    if (fstat(fd, &statbuf) == 0 && (size_t) statbuf.st_size == sizeof(header) + size &&
+        read(fd, &header, sizeof(header)) == sizeof(header) &&
+        !memcmp(&header, &expected, sizeof(header))) {
+        size_t done = 0;
+        while (done < size) {
+            const ssize_t n = read(fd, image->data + done, size - done);
+            if (n <= 0) break;
+            done += n;
+        }
+
+        result = done == size;
+        if (!result) memset(image->data, 0, size);
+    }
+
+    close(fd);
+    return result;
+}
+
+static void wallpaper_store_pixels(
+    const XImage            *image,
+    const WallpaperMonitors *monitors,
+    WallpaperMode            mode,
+    const char              *path,
+    const struct stat       *source) {
+    const WallpaperPixels header = wallpaper_pixels_header(image, monitors, mode, source);
+    const size_t          size = (size_t) image->bytes_per_line * image->height;
+
+    // Written under a temporary name and renamed, so a restore running meanwhile still reads the
+    // previous pixels, and an interrupted write leaves them in place
+    char temp[PATH_MAX];
+    int  fd = -1;
+    if (snprintf(temp, sizeof(temp), "%s.XXXXXX", path) < (int) sizeof(temp)) {
+        fd = mkostemp(temp, O_CLOEXEC);
+    }
+
+    FILE *f = fd < 0 ? NULL : fdopen(fd, "wb");
+    if (!f) {
+        fprintf(stderr, "ERROR: Could not store wallpaper pixels '%s'\n", path);
+        if (fd >= 0) {
+            close(fd);
+            unlink(temp);
+        }
+        return;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(image->data, size, 1, f) == 1;
+    ok &= fclose(f) == 0;
+    if (!ok || rename(temp, path) < 0) {
+        fprintf(stderr, "ERROR: Could not store wallpaper pixels '%s'\n", path);
+        unlink(temp);
+    }
+}
+
+typedef struct {
+    size_t x;
+    size_t y;
+    size_t width;
+    size_t height;
+} WallpaperRect;
+
+// The pixel of the XImage for an RGB color, for visuals the resizer has no layout for
+static unsigned long ximage_pixel(const XImage *image, const uint8_t *rgb) {
+    const unsigned long masks[] = {image->red_mask, image->green_mask, image->blue_mask};
+
+    unsigned long pixel = 0;
+    for (size_t i = 0; i < 3; i++) {
+        if (!masks[i]) continue;
+        const int shift = __builtin_ctzl(masks[i]);
+        pixel |= (rgb[i] * (masks[i] >> shift) / 0xFF) << shift;
+    }
+    return pixel;
+}
+
+// Resizes the part of the image inside the source rectangle into the destination rectangle of
+// the XImage. The crop is just an offset into the image, so the rest of it is never read. With a
+// GPU resizer the pixels are only written once it is finished
+static bool wallpaper_resize(
+    Pool          *pool,
+    ResizeGl      *gl,
+    XImage        *wallpaper,
+    const uint8_t *src,
+    size_t         w,
+    WallpaperRect  from,
+    WallpaperRect  to) {
+    const uint8_t *input = src + (from.y * w + from.x) * sizeof(uint32_t);
+
+    // Practically every visual stores its pixels in one of the layouts of the resizer, which then
+    // reorders the channels on the fly while writing the rows of the XImage
+    stbir_pixel_layout layout;
+    if (ximage_pixel_layout(wallpaper, &layout)) {
+        const size_t      offset = to.y * wallpaper->bytes_per_line + to.x * sizeof(uint32_t);
+        const ResizeImage in = {
+            (void *) input, from.width, from.height, w * sizeof(uint32_t), STBIR_RGBA};
+        const ResizeImage out = {
+            wallpaper->data + offset, to.width, to.height, wallpaper->bytes_per_line, layout};
+
+        if (gl && resize_gl_queue(gl, from.x, from.y, from.width, from.height, &out)) {
+            return true;
+        }
+        return resize(pool, &in, &out);
+    }
+
+    // Otherwise the crop is resized into a buffer first
+    uint8_t *image = malloc(to.width * to.height * sizeof(uint32_t));
+    if (!image) {
+        return false;
+    }
+
+    const ResizeImage in = {
+        (void *) input, from.width, from.height, w * sizeof(uint32_t), STBIR_RGBA};
+    const ResizeImage out = {image, to.width, to.height, 0, STBIR_RGBA};
+    if (!resize(pool, &in, &out)) {
+        free(image);
+        return false;
+    }
+
+    // Anything else, such as 16 bit visuals, goes through Xlib a pixel at a time
+    for (size_t y = 0; y < to.height; y++) {
+        for (size_t x = 0; x < to.width; x++) {
+            const uint8_t *it = &image[(y * to.width + x) * sizeof(uint32_t)];
+            XPutPixel(wallpaper, to.x + x, to.y + y, ximage_pixel(wallpaper, it));
+        }
+    }
+
+    free(image);
+    return true;
+}
+
+// Copies the part of the image inside the source rectangle to the XImage as is, reordering the
+// channels bytewise where the visual allows it
+static void wallpaper_copy(
+    XImage *wallpaper, const uint8_t *src, size_t w, WallpaperRect from, size_t x, size_t y) {
+    const int r = ximage_channel_byte(wallpaper, wallpaper->red_mask);
+    const int g = ximage_channel_byte(wallpaper, wallpaper->green_mask);
+    const int b = ximage_channel_byte(wallpaper, wallpaper->blue_mask);
+    const bool bytewise = wallpaper->bits_per_pixel == 32 && r >= 0 && g >= 0 && b >= 0;
+
+    for (size_t j = 0; j < from.height; j++) {
+        const uint8_t *row = src + ((from.y + j) * w + from.x) * sizeof(uint32_t);
+        if (bytewise) {
+            // The indices of the four bytes add up to 6, so the one left over holds the alpha
+            const int a = 6 - r - g - b;
+            uint8_t  *out = (uint8_t *) wallpaper->data + (y + j) * wallpaper->bytes_per_line +
+                           x * sizeof(uint32_t);
+
+            for (size_t i = 0; i < from.width; i++, row += 4, out += 4) {
+                out[r] = row[0];
+                out[g] = row[1];
+                out[b] = row[2];
+                out[a] = row[3];
+            }
+        } else {
+            for (size_t i = 0; i < from.width; i++, row += 4) {
+                XPutPixel(wallpaper, x + i, y + j, ximage_pixel(wallpaper, row));
+            }
+        }
+    }
+}
+
+// Places the image on the rectangle of the monitor on the XImage. The source rectangle is worked
+// out before anything is resampled, so only the pixels which end up on the monitor are read, and
+// centering or tiling does not resample at all
+static bool wallpaper_monitor(
+    Pool          *pool,
+    ResizeGl      *gl,
+    XImage        *wallpaper,
+    const uint8_t *src,
+    size_t         w,
+    size_t         h,
+    Monitor        monitor,
+    WallpaperMode  mode) {
+    const size_t mw = monitor.width;
+    const size_t mh = monitor.height;
+
+    WallpaperRect from = {0, 0, w, h};
+    WallpaperRect to = {monitor.x, monitor.y, mw, mh};
+    switch (mode) {
+    case WALLPAPER_STRETCH:
+        break;
+
+    case WALLPAPER_FILL:
+        if (w * mh > h * mw) {
+            from.width = (h * mw + mh / 2) / mh;
+        } else {
+            from.height = (w * mh + mw / 2) / mw;
+        }
+        from.width = from.width ? from.width : 1;
+        from.height = from.height ? from.height : 1;
+        from.x = (w - from.width) / 2;
+        from.y = (h - from.height) / 2;
+        break;
+
+    case WALLPAPER_FIT:
+        if (w * mh > h * mw) {
+            to.height = (h * mw + w / 2) / w;
+        } else {
+            to.width = (w * mh + h / 2) / h;
+        }
+        to.width = to.width ? to.width : 1;
+        to.height = to.height ? to.height : 1;
+        to.x += (mw - to.width) / 2;
+        to.y += (mh - to.height) / 2;
+        break;
+
+    case WALLPAPER_CENTER:
+        from.width = w < mw ? w : mw;
+        from.height = h < mh ? h : mh;
+        from.x = (w - from.width) / 2;
+        from.y = (h - from.height) / 2;
+        to.x += (mw - from.width) / 2;
+        to.y += (mh - from.height) / 2;
+        wallpaper_copy(wallpaper, src, w, from, to.x, to.y);
+        return true;
+
+    case WALLPAPER_TILE:
+        for (size_t y = 0; y < mh; y += h) {
+            for (size_t x = 0; x < mw; x += w) {
+                from.width = x + w < mw ? w : mw - x;
+                from.height = y + h < mh ? h : mh - y;
+                wallpaper_copy(wallpaper, src, w, from, to.x + x, to.y + y);
+            }
+        }
+        return true;
+    }
+
+    return wallpaper_resize(pool, gl, wallpaper, src, w, from, to);
+}
+
+// The image is resized to every monitor on its own, so the pixels are not stretched across
+// monitors of different sizes. The pixels scaled to the monitors are reused from the given path if
+// they are still up to date, or stored there otherwise, so restoring a wallpaper skips decoding
+// and resizing the image
+static int wallpaper(App *a, const char *path, WallpaperMode mode, const char *pixels) {
     int      result = 0;
-    uint8_t *image = NULL;
+    uint8_t *src = NULL;
 
-    int      w, h;
-    uint8_t *src = stbi_load(path, &w, &h, NULL, sizeof(uint32_t));
-    if (!src) {
+    struct stat source = {0};
+    if (stat(path, &source) < 0) {
         fprintf(stderr, "ERROR: Could not load image '%s'\n", path);
         return_defer(1);
     }
@@ -48,14 +446,6 @@ static int wallpaper(App *a, const char *path) {
 
     size_t width = a->size.x;
     size_t height = a->size.y;
-    image = stbir_resize_uint8_linear(
-        src, w, h, w * sizeof(uint32_t), NULL, width, height, width * sizeof(uint32_t), STBIR_RGBA);
-
-    stbi_image_free(src);
-    if (!image) {
-        fprintf(stderr, "ERROR: Failed to resize image to %zux%zu\n", width, height);
-        return_defer(1);
-    }
 
     a->wallpaper = XCreateImage(
         a->display,
@@ -74,28 +464,149 @@ static int wallpaper(App *a, const char *path) {
         return_defer(1);
     }
 
-    a->wallpaper->data = malloc(a->wallpaper->bytes_per_line * height);
-    if (!a->wallpaper->data) {
-        fprintf(stderr, "ERROR: Could not create XImage\n");
+    // The pixels are resized straight into a segment shared with the server, so they are sent to
+    // it without another copy. Whatever no monitor covers stays black, as segments start zeroed
+    const size_t size = height * a->wallpaper->bytes_per_line;
+    if (shm_attach(a->display, &a->wallpaper_shm, size, true)) {
+        a->wallpaper->data = a->wallpaper_shm.shmaddr;
+        a->wallpaper->obdata = (char *) &a->wallpaper_shm;
+    } else {
+        a->wallpaper->data = calloc(height, a->wallpaper->bytes_per_line);
+        if (!a->wallpaper->data) {
+            fprintf(stderr, "ERROR: Could not create XImage\n");
+            return_defer(1);
+        }
+    }
+
+    WallpaperMonitors monitors = {0};
+    monitors.count = monitors_query(a->display, monitors.data, WALLPAPER_MONITORS_MAX);
+
+    if (pixels && wallpaper_load_pixels(a->wallpaper, &monitors, mode, pixels, &source)) {
+        app_wallpaper(a);
+        return_defer(0);
+    }
+
+    int w, h;
+    src = stbi_load(path, &w, &h, NULL, sizeof(uint32_t));
+    if (!src) {
+        fprintf(stderr, "ERROR: Could not load image '%s'\n", path);
         return_defer(1);
     }
 
-    for (size_t y = 0; y < height; y++) {
-        for (size_t x = 0; x < width; x++) {
-            const uint8_t  r = image[(y * width + x) * sizeof(uint32_t) + 0];
-            const uint8_t  g = image[(y * width + x) * sizeof(uint32_t) + 1];
-            const uint8_t  b = image[(y * width + x) * sizeof(uint32_t) + 2];
-            const uint32_t pixel = ((r & 0xff) << 16) | ((g & 0xff) << 8) | (b & 0xff);
-            XPutPixel(a->wallpaper, x, y, pixel);
+    // The resize dominates setting a wallpaper, so it is done on the GPU if there is one, and
+    // split across every core otherwise
+    ResizeGl  gl;
+    ResizeGl *gpu = NULL;
+    if (mode != WALLPAPER_CENTER && mode != WALLPAPER_TILE && resize_gl_init(&gl, a->display)) {
+        if (resize_gl_upload(&gl, src, w, h)) {
+            gpu = &gl;
+        } else {
+            resize_gl_free(&gl);
+        }
+    }
+
+    Pool pool;
+    pool_init(&pool, 0);
+
+    // Each monitor is split across the whole pool in turn, rather than giving every monitor a
+    // thread of its own, so a large monitor next to a small one does not leave threads idle. The
+    // GPU renders every monitor before any of them is read back
+    bool resized = true;
+    for (size_t i = 0; i < monitors.count && resized; i++) {
+        const Monitor *m = &monitors.data[i];
+        resized = wallpaper_monitor(&pool, gpu, a->wallpaper, src, w, h, *m, mode);
+        if (!resized) {
+            fprintf(stderr, "ERROR: Failed to resize image to %zux%zu\n", m->width, m->height);
         }
     }
+    pool_free(&pool);
 
+    if (gpu) {
+        if (!resize_gl_finish(gpu) && resized) {
+            fprintf(stderr, "ERROR: Failed to read back the resized image\n");
+            resized = false;
+        }
+        resize_gl_free(gpu);
+    }
+
+    if (!resized) return_defer(1);
+
+    if (pixels) {
+        wallpaper_store_pixels(a->wallpaper, &monitors, mode, pixels, &source);
+    }
     app_wallpaper(a);
 
 defer:
-    if (image) stbi_image_free(image);
+    if (src) stbi_image_free(src);
+    app_wallpaper_free(a);
     if (a->display) XCloseDisplay(a->display);
-    if (a->wallpaper) XDestroyImage(a->wallpaper);
+    return result;
+}
+
+// The label names what the size is for in the error
+static bool parse_size(const char *s, const char *label, size_t *size) {
+    char *endptr;
+    errno = 0;
+    *size = strtoul(s, &endptr, 10);
+    if (*endptr != '\0' || *s == '-' || *size == 0 || errno == ERANGE) {
+        fprintf(stderr, "ERROR: Invalid %s '%s'\n", label, s);
+        return false;
+    }
+    return true;
+}
+
+// If stdin already is a sealed memfd it is handed over as is, otherwise the pixels are streamed
+// into a fresh memfd which then gets sealed
+static bool read_pixels(Pixels *p) {
+    bool result = true;
+
+    if (p->width > SIZE_MAX / sizeof(Pixel) / p->height) {
+        fprintf(stderr, "ERROR: Invalid pixel buffer size %zux%zu\n", p->width, p->height);
+        return false;
+    }
+
+    const int    required = F_SEAL_WRITE | F_SEAL_SHRINK;
+    const size_t size = p->width * p->height * sizeof(Pixel);
+    if ((fcntl(STDIN_FILENO, F_GET_SEALS) & required) == required) {
+        p->fd = dup(STDIN_FILENO);
+        return p->fd >= 0;
+    }
+
+    uint8_t *data = MAP_FAILED;
+    p->fd = memfd_create("thono", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (p->fd < 0 || ftruncate(p->fd, size) < 0) {
+        fprintf(stderr, "ERROR: Could not create pixel buffer\n");
+        return_defer(false);
+    }
+
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, p->fd, 0);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "ERROR: Could not map pixel buffer\n");
+        return_defer(false);
+    }
+
+    for (size_t count = 0; count < size;) {
+        const ssize_t n = read(STDIN_FILENO, data + count, size - count);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            fprintf(stderr, "ERROR: Expected %zu bytes of pixels on stdin, got %zu\n", size, count);
+            return_defer(false);
+        }
+        count += n;
+    }
+
+    // The write seal can only be applied after the writable mapping is gone
+    munmap(data, size);
+    data = MAP_FAILED;
+
+    if (fcntl(p->fd, F_ADD_SEALS, required | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+        fprintf(stderr, "ERROR: Could not seal pixel buffer\n");
+        return_defer(false);
+    }
+
+defer:
+    if (data != MAP_FAILED) munmap(data, size);
+    if (!result && p->fd >= 0) close(p->fd);
     return result;
 }
 
@@ -111,19 +622,18 @@ static void print_quoted_path(FILE *f, const char *s) {
     fputc('\'', f);
 }
 
-static int wallpaper_restore(App *a, const char *image_path, const char *script_path) {
+static int wallpaper_restore(
+    App *a, const char *image_path, WallpaperMode mode, const char *script_path) {
     int result = 0;
     DynamicArray(char) b = {0};
-
-    result = wallpaper(a, image_path);
-    if (result) return_defer(result);
+    DynamicArray(char) pixels = {0};
 
     if (script_path) {
         da_append_cstr(&b, script_path);
         da_append(&b, '\0');
     } else {
         const char *env_home = getenv("HOME");
-        if (!env_home) return_defer(result);
+        if (!env_home) return_defer(wallpaper(a, image_path, mode, NULL));
 
         da_append_cstr(&b, env_home);
         da_append(&b, '/');
@@ -131,6 +641,14 @@ static int wallpaper_restore(App *a, const char *image_path, const char *script_
         da_append(&b, '\0');
     }
 
+    // The pixels scaled to the screen are stored next to the script, which passes them back
+    da_append_cstr(&pixels, b.data);
+    da_append_cstr(&pixels, WALLPAPER_PIXELS_SUFFIX);
+    da_append(&pixels, '\0');
+
+    result = wallpaper(a, image_path, mode, pixels.data);
+    if (result) return_defer(result);
+
     const size_t program = b.count;
     while (true) {
         da_append_many(&b, NULL, DA_INIT_CAP);
@@ -180,9 +698,9 @@ static int wallpaper_restore(App *a, const char *image_path, const char *script_
 
     fprintf(f, "#!/bin/sh\n");
     print_quoted_path(f, b.data + program);
-    fprintf(f, " -w ");
+    fprintf(f, " -m %s -w ", wallpaper_mode_names[mode]);
     print_quoted_path(f, b.data + wallpaper);
-    fprintf(f, "\n");
+    fprintf(f, " \"$0%s\"\n", WALLPAPER_PIXELS_SUFFIX);
     fclose(f);
 
     if (chmod(b.data, 0755) == -1) {
@@ -194,34 +712,158 @@ static int wallpaper_restore(App *a, const char *image_path, const char *script_
     printf("Created wallpaper restore script '%s'\n", b.data);
 
 defer:
+    da_free(&pixels);
     da_free(&b);
     return result;
 }
 
+// Any of the frame rate, the region and the output can be given, told apart by their form
+static int record(App *a, const char **args, size_t count) {
+    int result = 0;
+
+    size_t      fps = RECORD_FPS_DEFAULT;
+    XRectangle  region = {0, 0, a->size.x, a->size.y};
+    const char *output = "-";
+    for (size_t i = 0; i < count; i++) {
+        int          x = 0, y = 0;
+        unsigned int width, height;
+
+        const char  *arg = args[i];
+        const int    mask = XParseGeometry(arg, &x, &y, &width, &height);
+        const size_t digits = strspn(arg, "0123456789");
+        if (*arg && !arg[digits]) {
+            if (!parse_size(arg, "frame rate", &fps)) return 1;
+            if (fps > RECORD_FPS_MAX) {
+                fprintf(stderr, "ERROR: Invalid frame rate '%s'\n", arg);
+                return 1;
+            }
+        } else if ((mask & WidthValue) && (mask & HeightValue)) {
+            if (mask & XNegative) x += a->size.x - width;
+            if (mask & YNegative) y += a->size.y - height;
+            if (x < 0 || y < 0 || !width || !height || x + width > a->size.x ||
+                y + height > a->size.y) {
+                fprintf(stderr, "ERROR: Region '%s' is not on the screen\n", arg);
+                return 1;
+            }
+            region = (XRectangle) {x, y, width, height};
+        } else {
+            output = arg;
+        }
+    }
+
+    const size_t length = strlen(output);
+    const bool   y4m =
+        !strcmp(output, "-") || (length >= 4 && !strcmp(output + length - 4, ".y4m"));
+
+    int fd = STDOUT_FILENO;
+    if (strcmp(output, "-")) {
+        fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "ERROR: Could not open '%s'\n", output);
+            return 1;
+        }
+    } else if (isatty(fd)) {
+        fprintf(stderr, "ERROR: Refusing to write the recording to a terminal\n");
+        return 1;
+    }
+
+    Recorder r;
+    if (!record_start(&r, a->display, region, y4m ? RECORD_Y4M : RECORD_RAW, fps, fd)) {
+        fprintf(stderr, "ERROR: Recording needs XDamage and MIT-SHM on a local display\n");
+        return_defer(1);
+    }
+
+    if (!record_run(&r)) {
+        fprintf(stderr, "ERROR: Could not write the recording to '%s'\n", output);
+        result = 1;
+    }
+
+    // The output is the video, so this goes next to the errors
+    fprintf(
+        stderr,
+        "Recorded %zu frames of %dx%d, repeating %zu in place of dropped ones\n",
+        r.frames,
+        region.width,
+        region.height,
+        r.dropped);
+    record_stop(&r);
+
+defer:
+    if (fd != STDOUT_FILENO) close(fd);
+    return result;
+}
+
 int main(int argc, const char **argv) {
     App app = {0};
+
+    WallpaperMode mode = WALLPAPER_STRETCH;
+    if (argc >= 2 && !strcmp(argv[1], "-m")) {
+        if (argc == 2) {
+            fprintf(stderr, "ERROR: Wallpaper mode not provided\n");
+            fprintf(stderr, "Usage: thono -m <mode> -w <image>\n");
+            return 1;
+        }
+
+        if (!wallpaper_parse_mode(argv[2], &mode)) return 1;
+        argv += 2;
+        argc -= 2;
+    }
+
     if (argc >= 2) {
         const char *flag = argv[1];
         if (!strcmp(flag, "-h")) {
             usage(stdout);
             return 0;
         } else if (!strcmp(flag, "-s")) {
-            if (argc > 2) {
-                char        *endptr;
-                const size_t delay = strtoul(argv[2], &endptr, 10);
+            size_t burst = 1;
+            size_t interval = BURST_INTERVAL_DEFAULT;
+            size_t delay = 0;
+            for (int i = 2; i < argc; i++) {
+                if (!strcmp(argv[i], "--burst") || !strcmp(argv[i], "--interval")) {
+                    if (i + 1 == argc) {
+                        fprintf(stderr, "ERROR: No value provided for '%s'\n", argv[i]);
+                        return 1;
+                    }
+
+                    const bool is_burst = !strcmp(argv[i], "--burst");
+                    size_t    *value = is_burst ? &burst : &interval;
+                    if (!parse_size(argv[++i], is_burst ? "burst count" : "interval", value)) {
+                        return 1;
+                    }
+                    continue;
+                }
+
+                char *endptr;
+                delay = strtoul(argv[i], &endptr, 10);
 
                 if (*endptr != '\0' || (delay == ULONG_MAX && errno == ERANGE)) {
-                    fprintf(stderr, "ERROR: Invalid delay '%s'\n", argv[2]);
+                    fprintf(stderr, "ERROR: Invalid delay '%s'\n", argv[i]);
                     return 1;
                 }
-
-                sleep(delay);
             }
 
+            sleep(delay);
             app_init(&app);
-            app_screenshot(&app);
+            if (burst == 1) {
+                app_screenshot(&app);
+                XCloseDisplay(app.display);
+                return 0;
+            }
+
+            Burst b;
+            if (!burst_init(&b, app.display, burst)) {
+                fprintf(stderr, "ERROR: Burst screenshots need MIT-SHM and 32 bit pixels\n");
+                XCloseDisplay(app.display);
+                return 1;
+            }
+
+            const bool saved = burst_run(&b, burst, interval);
+            if (b.late) {
+                fprintf(stderr, "%zu screenshots were late waiting for a free frame\n", b.late);
+            }
+            burst_free(&b);
             XCloseDisplay(app.display);
-            return 0;
+            return !saved;
         } else if (!strcmp(flag, "-r")) {
             if (argc > 2) {
                 char        *endptr;
@@ -243,6 +885,11 @@ int main(int argc, const char **argv) {
             app_loop(&app);
             app_exit(&app);
             return 0;
+        } else if (!strcmp(flag, "-v")) {
+            app_init(&app);
+            const int result = record(&app, argv + 2, argc - 2);
+            XCloseDisplay(app.display);
+            return result;
         } else if (!strcmp(flag, "-w")) {
             if (argc == 2) {
                 fprintf(stderr, "ERROR: Wallpaper image not provided\n");
@@ -250,7 +897,7 @@ int main(int argc, const char **argv) {
                 return 1;
             }
 
-            return wallpaper(&app, argv[2]);
+            return wallpaper(&app, argv[2], mode, argc > 3 ? argv[3] : NULL);
         } else if (!strcmp(flag, "-W")) {
             if (argc == 2) {
                 fprintf(stderr, "ERROR: Wallpaper image not provided\n");
@@ -258,7 +905,19 @@ int main(int argc, const char **argv) {
                 return 1;
             }
 
-            return wallpaper_restore(&app, argv[2], argc > 3 ? argv[3] : NULL);
+            return wallpaper_restore(&app, argv[2], mode, argc > 3 ? argv[3] : NULL);
+        } else if (!strcmp(flag, "-p")) {
+            if (argc != 4) {
+                fprintf(stderr, "ERROR: Pixel buffer size not provided\n");
+                fprintf(stderr, "Usage: thono -p <width> <height>\n");
+                return 1;
+            }
+
+            if (!parse_size(argv[2], "size", &app.pixels.width)) return 1;
+            if (!parse_size(argv[3], "size", &app.pixels.height)) return 1;
+            if (!read_pixels(&app.pixels)) return 1;
+
+            argc = 1;
         } else if (!strcmp(flag, "-R")) {
             app.recursive = true;
             argv++;
@@ -0,0 +1,108 @@
+#include <stdlib.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+
+#include "la.h"
+#include "mipmap.h"
+
+size_t mipmap_levels(size_t width, size_t height) {
+    size_t levels = 1;
+    while (width > 1 || height > 1) {
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        levels++;
+    }
+    return levels;
+}
+
+void mipmap_level_size(size_t width, size_t height, size_t level, size_t *w, size_t *h) {
+    *w = width >> level ? width >> level : 1;
+    *h = height >> level ? height >> level : 1;
+}
+
+size_t mipmap_level_offset(size_t width, size_t height, size_t level) {
+    size_t offset = 0;
+    for (size_t i = 1; i < level; i++) {
+        size_t w, h;
+        mipmap_level_size(width, height, i, &w, &h);
+        offset += w * h;
+    }
+    return offset;
+}
+
+// Each texel averages a 2x2 block. Level sizes round down, so the last column or row of an odd
+// sized level is skipped, and the clamp only matters when a side is already a single texel
+static void mipmap_downsample(
+    const uint8_t *src,
+    size_t         sw,
+    size_t         sh,
+    uint8_t       *dst,
+    size_t         dw,
+    size_t         dh,
+    size_t         channels) {
+    for (size_t y = 0; y < dh; y++) {
+        const uint8_t *row0 = src + min(2 * y, sh - 1) * sw * channels;
+        const uint8_t *row1 = src + min(2 * y + 1, sh - 1) * sw * channels;
+        uint8_t       *out = dst + y * dw * channels;
+
+        size_t x = 0;
+#ifdef __SSE2__
+        // Two output pixels per step, whose four input columns are all within the row
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(2);
+        for (; channels == 4 && 2 * x + 3 < sw && x + 1 < dw; x += 2) {
+            const __m128i a = _mm_loadu_si128((const __m128i *) (row0 + 8 * x));
+            const __m128i b = _mm_loadu_si128((const __m128i *) (row1 + 8 * x));
+
+            const __m128i lo =
+                _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            const __m128i hi =
+                _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+            // Columns 0 and 2 against 1 and 3
+            __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, bias), 2);
+            _mm_storel_epi64((__m128i *) (out + 4 * x), _mm_packus_epi16(sum, sum));
+        }
+#endif // __SSE2__
+
+        for (; x < dw; x++) {
+            const size_t x0 = min(2 * x, sw - 1) * channels;
+            const size_t x1 = min(2 * x + 1, sw - 1) * channels;
+            for (size_t c = 0; c < channels; c++) {
+                const uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                out[x * channels + c] = (sum + 2) >> 2;
+            }
+        }
+    }
+}
+
+uint8_t *mipmap_build(const uint8_t *base, size_t width, size_t height, size_t channels) {
+    const size_t levels = mipmap_levels(width, height);
+    if (levels == 1) {
+        return NULL;
+    }
+
+    uint8_t *mipmaps = malloc(mipmap_level_offset(width, height, levels) * channels);
+    if (!mipmaps) {
+        return NULL;
+    }
+
+    const uint8_t *src = base;
+    size_t         sw = width, sh = height;
+    for (size_t level = 1; level < levels; level++) {
+        size_t dw, dh;
+        mipmap_level_size(width, height, level, &dw, &dh);
+
+        uint8_t *dst = mipmaps + mipmap_level_offset(width, height, level) * channels;
+        mipmap_downsample(src, sw, sh, dst, dw, dh, channels);
+
+        src = dst;
+        sw = dw;
+        sh = dh;
+    }
+
+    return mipmaps;
+}
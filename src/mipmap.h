@@ -0,0 +1,21 @@
+#ifndef MIPMAP_H
+#define MIPMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Number of levels in the full chain down to 1x1, including the base level
+size_t mipmap_levels(size_t width, size_t height);
+
+// Size of the level in pixels. Every level halves the previous one, rounding down, but never
+// goes below a single pixel
+void mipmap_level_size(size_t width, size_t height, size_t level, size_t *w, size_t *h);
+
+// Offset of the level in pixels, within the levels past the base one packed one after another
+size_t mipmap_level_offset(size_t width, size_t height, size_t level);
+
+// Builds every level past the base one into a single allocation with a 2x2 box filter, returns
+// NULL if out of memory. Pixels are tightly packed with any number of 8 bit channels
+uint8_t *mipmap_build(const uint8_t *base, size_t width, size_t height, size_t channels);
+
+#endif // MIPMAP_H
@@ -0,0 +1,96 @@
+#include <dlfcn.h>
+#include <stdbool.h>
+
+#include <X11/extensions/randr.h>
+
+#include "monitor.h"
+
+// The leading members of the XRandR structures which are used, as declared by Xrandr.h. Only the
+// library is needed at runtime, so the development headers are not required to build
+typedef XID RRCrtc;
+typedef XID RROutput;
+typedef XID RRMode;
+
+typedef struct {
+    Time      timestamp;
+    Time      config_timestamp;
+    int       ncrtc;
+    RRCrtc   *crtcs;
+    int       noutput;
+    RROutput *outputs;
+} XRRScreenResources;
+
+typedef struct {
+    Time         timestamp;
+    int          x;
+    int          y;
+    unsigned int width;
+    unsigned int height;
+    RRMode       mode;
+} XRRCrtcInfo;
+
+typedef struct {
+    void *library;
+
+    XRRScreenResources *(*get_screen_resources)(Display *display, Window window);
+    void (*free_screen_resources)(XRRScreenResources *resources);
+    XRRCrtcInfo *(*get_crtc_info)(Display *display, XRRScreenResources *resources, RRCrtc crtc);
+    void (*free_crtc_info)(XRRCrtcInfo *info);
+} XRandR;
+
+static bool xrandr_load(XRandR *x) {
+    // Never closed, since the library hooks into the display to clean up once it is closed
+    x->library = dlopen("libXrandr.so.2", RTLD_NOW | RTLD_LOCAL);
+    if (!x->library) {
+        return false;
+    }
+
+    // Does not reprobe the outputs like XRRGetScreenResources does, which can take a while
+    *(void **) &x->get_screen_resources = dlsym(x->library, "XRRGetScreenResourcesCurrent");
+    *(void **) &x->free_screen_resources = dlsym(x->library, "XRRFreeScreenResources");
+    *(void **) &x->get_crtc_info = dlsym(x->library, "XRRGetCrtcInfo");
+    *(void **) &x->free_crtc_info = dlsym(x->library, "XRRFreeCrtcInfo");
+    return x->get_screen_resources && x->free_screen_resources && x->get_crtc_info &&
+           x->free_crtc_info;
+}
+
+size_t monitors_query(Display *display, Monitor *monitors, size_t max) {
+    const int    screen = DefaultScreen(display);
+    const int    root_width = DisplayWidth(display, screen);
+    const int    root_height = DisplayHeight(display, screen);
+    const Window root = RootWindow(display, screen);
+
+    size_t count = 0;
+    XRandR x = {0};
+    int    opcode, event_base, error_base;
+    if (max && xrandr_load(&x) &&
+        XQueryExtension(display, RANDR_NAME, &opcode, &event_base, &error_base)) {
+        XRRScreenResources *resources = x.get_screen_resources(display, root);
+        for (int i = 0; resources && i < resources->ncrtc && count < max; i++) {
+            XRRCrtcInfo *info = x.get_crtc_info(display, resources, resources->crtcs[i]);
+            if (!info) continue;
+
+            // Disabled outputs have no mode
+            if (info->mode != None) {
+                const int x0 = info->x > 0 ? info->x : 0;
+                const int y0 = info->y > 0 ? info->y : 0;
+                const int x1 = info->x + (int) info->width;
+                const int y1 = info->y + (int) info->height;
+                const int width = (x1 < root_width ? x1 : root_width) - x0;
+                const int height = (y1 < root_height ? y1 : root_height) - y0;
+                if (width > 0 && height > 0) {
+                    monitors[count++] = (Monitor) {x0, y0, width, height};
+                }
+            }
+            x.free_crtc_info(info);
+        }
+
+        if (resources) x.free_screen_resources(resources);
+    }
+
+    if (!count && max) {
+        monitors[count++] = (Monitor) {0, 0, root_width, root_height};
+    }
+
+    return count;
+}
@@ -0,0 +1,20 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <stddef.h>
+
+#include <X11/Xlib.h>
+
+typedef struct {
+    int    x;
+    int    y;
+    size_t width;
+    size_t height;
+} Monitor;
+
+// Queries the rectangles of the active outputs on the root window with XRandR, clipped to the
+// root. XRandR is loaded at runtime, so without it, or without any active output, the whole root
+// is a single monitor. Returns the amount of monitors written, which is at most max
+size_t monitors_query(Display *display, Monitor *monitors, size_t max);
+
+#endif // MONITOR_H
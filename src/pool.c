@@ -0,0 +1,99 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "pool.h"
+
+// Runs indices of the current job until there are none left. Expects the mutex to be held
+static void pool_drain(Pool *p) {
+    while (p->next < p->total) {
+        const size_t index = p->next++;
+
+        pthread_mutex_unlock(&p->mutex);
+        p->fn(p->data, index);
+        pthread_mutex_lock(&p->mutex);
+
+        if (++p->finished == p->total) {
+            pthread_cond_broadcast(&p->done);
+        }
+    }
+}
+
+static void *pool_worker(void *arg) {
+    Pool *p = arg;
+
+    pthread_mutex_lock(&p->mutex);
+    size_t generation = p->generation;
+    while (true) {
+        while (!p->quit && p->generation == generation) {
+            pthread_cond_wait(&p->wake, &p->mutex);
+        }
+
+        if (p->quit) break;
+        generation = p->generation;
+        pool_drain(p);
+    }
+    pthread_mutex_unlock(&p->mutex);
+
+    return NULL;
+}
+
+void pool_init(Pool *p, size_t count) {
+    if (!count) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count = online > 0 ? online : 1;
+    }
+
+    // The calling thread takes part in every job as well
+    p->count = count - 1;
+    p->threads = malloc(p->count * sizeof(*p->threads));
+    if (p->count && !p->threads) {
+        fprintf(stderr, "ERROR: Could not allocate thread pool\n");
+        exit(1);
+    }
+
+    pthread_mutex_init(&p->mutex, NULL);
+    pthread_cond_init(&p->wake, NULL);
+    pthread_cond_init(&p->done, NULL);
+
+    for (size_t i = 0; i < p->count; i++) {
+        if (pthread_create(&p->threads[i], NULL, pool_worker, p)) {
+            fprintf(stderr, "ERROR: Could not create worker thread\n");
+            exit(1);
+        }
+    }
+}
+
+void pool_free(Pool *p) {
+    pthread_mutex_lock(&p->mutex);
+    p->quit = true;
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->mutex);
+
+    for (size_t i = 0; i < p->count; i++) {
+        pthread_join(p->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&p->done);
+    pthread_cond_destroy(&p->wake);
+    pthread_mutex_destroy(&p->mutex);
+    free(p->threads);
+}
+
+void pool_for(Pool *p, PoolFn fn, void *data, size_t count) {
+    pthread_mutex_lock(&p->mutex);
+    p->fn = fn;
+    p->data = data;
+    p->next = 0;
+    p->total = count;
+    p->finished = 0;
+    p->generation++;
+    pthread_cond_broadcast(&p->wake);
+
+    pool_drain(p);
+    while (p->finished < p->total) {
+        pthread_cond_wait(&p->done, &p->mutex);
+    }
+    pthread_mutex_unlock(&p->mutex);
+}
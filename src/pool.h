@@ -0,0 +1,35 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef void (*PoolFn)(void *data, size_t index);
+
+typedef struct {
+    pthread_t *threads;
+    size_t     count;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t  wake;
+    pthread_cond_t  done;
+
+    PoolFn fn;
+    void  *data;
+    size_t next;
+    size_t total;
+    size_t finished;
+    size_t generation;
+    bool   quit;
+} Pool;
+
+// A count of zero uses one thread per online CPU
+void pool_init(Pool *p, size_t count);
+void pool_free(Pool *p);
+
+// Calls fn for every index in [0, count) across the pool and the calling thread, and returns once
+// all of them are done
+void pool_for(Pool *p, PoolFn fn, void *data, size_t count);
+
+#endif // POOL_H
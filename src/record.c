@@ -0,0 +1,214 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <X11/Xutil.h>
+
+#include "record.h"
+#include "shm.h"
+
+static volatile sig_atomic_t record_interrupted;
+
+static void record_interrupt(int signal) {
+    (void) signal;
+    record_interrupted = 1;
+}
+
+static int64_t record_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Returns the error of the failed write, 0 if everything was written
+static int record_write(int fd, const void *data, size_t size) {
+    const uint8_t *p = data;
+    while (size) {
+        const ssize_t n = write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+
+        p += n;
+        size -= n;
+    }
+    return 0;
+}
+
+static int record_write_frame(Recorder *r) {
+    const int error = r->format == RECORD_Y4M ? record_write(r->fd, "FRAME\n", 6) : 0;
+    if (error) return error;
+    return record_write(r->fd, r->frame, r->frame_size);
+}
+
+bool record_start(
+    Recorder    *r,
+    Display     *display,
+    XRectangle   region,
+    RecordFormat format,
+    int          fps,
+    int          fd) {
+    *r = (Recorder) {
+        .display = display,
+        .root = DefaultRootWindow(display),
+        .region = region,
+        .format = format,
+        .fps = fps,
+        .fd = fd,
+    };
+
+    if (!damage_init(display, &r->damage_event)) {
+        return false;
+    }
+
+    const int screen = DefaultScreen(display);
+    r->image = XShmCreateImage(
+        display,
+        DefaultVisual(display, screen),
+        DefaultDepth(display, screen),
+        ZPixmap,
+        NULL,
+        &r->shm,
+        region.width,
+        region.height);
+    if (!r->image) {
+        return false;
+    }
+
+    if (!shm_attach(display, &r->shm, r->image->bytes_per_line * region.height, false)) {
+        XDestroyImage(r->image);
+        r->image = NULL;
+        return false;
+    }
+    r->image->data = r->shm.shmaddr;
+
+    r->frame_size = (size_t) region.width * region.height * 3;
+    r->frame = malloc(r->frame_size);
+    r->row = malloc(region.width * 3);
+    if (!r->frame || !r->row) {
+        fprintf(stderr, "ERROR: Could not allocate frame\n");
+        exit(1);
+    }
+
+    // The first frame reads the whole region
+    r->damage = damage_create(display, r->root);
+    const XRectangle all = {0, 0, region.width, region.height};
+    damage_add(&r->pending, region.width, region.height, all);
+    return true;
+}
+
+// Reads the rectangle of the region into the frame
+static void record_capture(Recorder *r, XRectangle rect) {
+    // The image is reshaped rather than created anew, so reading allocates nothing
+    XImage *image = r->image;
+    image->width = rect.width;
+    image->height = rect.height;
+    image->bytes_per_line = (rect.width * image->bits_per_pixel + image->bitmap_pad - 1) /
+                            image->bitmap_pad * image->bitmap_pad / 8;
+
+    const int x0 = r->region.x + rect.x;
+    const int y0 = r->region.y + rect.y;
+    if (!XShmGetImage(r->display, r->root, image, x0, y0, AllPlanes)) {
+        return;
+    }
+
+    const size_t width = r->region.width;
+    if (r->format == RECORD_RAW) {
+        const XRectangle all = {0, 0, rect.width, rect.height};
+        shm_unpack(image, all, &r->frame[(rect.y * width + rect.x) * 3], width, 3);
+        return;
+    }
+
+    const size_t plane = width * r->region.height;
+    for (int y = 0; y < rect.height; y++) {
+        shm_unpack(image, (XRectangle) {0, y, rect.width, 1}, r->row, rect.width, 3);
+
+        // BT.601 with limited range, which is what players assume when Y4M does not say
+        uint8_t *it = &r->frame[(rect.y + y) * width + rect.x];
+        for (int x = 0; x < rect.width; x++, it++) {
+            const int red = r->row[x * 3 + 0];
+            const int green = r->row[x * 3 + 1];
+            const int blue = r->row[x * 3 + 2];
+            it[0] = ((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16;
+            it[plane] = ((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128;
+            it[plane * 2] = ((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128;
+        }
+    }
+}
+
+bool record_run(Recorder *r) {
+    // Interrupting stops the recording, and a reader which went away shows up as a failed write
+    const struct sigaction sa = {.sa_handler = record_interrupt};
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (r->format == RECORD_Y4M) {
+        char      header[128];
+        const int n = snprintf(
+            header,
+            sizeof(header),
+            "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n",
+            r->region.width,
+            r->region.height,
+            r->fps);
+        const int error = record_write(r->fd, header, n);
+        if (error) return error == EPIPE;
+    }
+
+    const int64_t period = 1000000000 / r->fps;
+    int64_t       next = record_now();
+    while (!record_interrupted) {
+        while (XPending(r->display)) {
+            XEvent e;
+            XNextEvent(r->display, &e);
+            if (e.type != r->damage_event) continue;
+
+            // The root is at the origin of the screen
+            const DamageNotifyEvent *d = (const DamageNotifyEvent *) &e;
+            XRectangle               rect = d->area;
+            rect.x -= r->region.x;
+            rect.y -= r->region.y;
+            damage_add(&r->pending, r->region.width, r->region.height, rect);
+        }
+
+        for (size_t i = 0; i < r->pending.count; i++) {
+            record_capture(r, r->pending.data[i]);
+        }
+        r->pending.count = 0;
+
+        // The streams have a fixed rate and no timestamps, so ticks which already passed get the
+        // last frame again in their place, which keeps the recording as long as the time it took
+        next += period;
+        const int64_t now = record_now();
+        const int64_t missed = now > next ? (now - next) / period : 0;
+        next += missed * period;
+        r->dropped += missed;
+
+        for (int64_t i = 0; i <= missed; i++) {
+            const int error = record_write_frame(r);
+            if (error) return error == EPIPE;
+            r->frames++;
+        }
+
+        const struct timespec ts = {next / 1000000000, next % 1000000000};
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+
+    return true;
+}
+
+void record_stop(Recorder *r) {
+    damage_destroy(r->display, r->damage);
+    shm_detach(r->display, &r->shm);
+    r->image->data = NULL;
+    XDestroyImage(r->image);
+    free(r->frame);
+    free(r->row);
+    *r = (Recorder) {0};
+}
@@ -0,0 +1,57 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
+
+#include "damage.h"
+
+typedef enum {
+    RECORD_RAW, // Packed 8 bit RGB frames, one after another
+    RECORD_Y4M, // YUV4MPEG2 with full resolution 4:4:4 chroma
+} RecordFormat;
+
+// Records a region of the screen at a steady rate. Only the parts XDamage reports as changed are
+// read again, into a frame kept from one tick to the next, so an idle screen costs next to nothing.
+// Everything is allocated up front and nothing is allocated while recording
+typedef struct {
+    Display     *display;
+    Window       root;
+    XRectangle   region; // On the screen
+    RecordFormat format;
+    int          fps;
+    int          fd;
+
+    int         damage_event;
+    Damage      damage;
+    DamageRects pending; // Relative to the region
+
+    XShmSegmentInfo shm;
+    XImage         *image; // Over the segment, reshaped to every rectangle read into it
+
+    uint8_t *frame; // Packed RGB, or the Y, U and V planes
+    size_t   frame_size;
+    uint8_t *row; // RGB of a row read into the frame, converted from for Y4M
+
+    size_t frames;  // Written so far, including the repeated ones
+    size_t dropped; // Ticks missed because a frame took too long, which repeat the previous one
+} Recorder;
+
+// Returns false if XDamage or MIT-SHM is missing, or on remote displays
+bool record_start(
+    Recorder    *r,
+    Display     *display,
+    XRectangle   region,
+    RecordFormat format,
+    int          fps,
+    int          fd);
+
+// Records until interrupted or until the output is closed. Returns false if writing failed
+bool record_run(Recorder *r);
+void record_stop(Recorder *r);
+
+#endif // RECORD_H
@@ -0,0 +1,111 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "resize.h"
+
+static const ResizeKernels resize_kernels_default = {
+    .init = stbir_resize_init,
+    .set_pixel_layouts = stbir_set_pixel_layouts,
+    .build_samplers_with_splits = stbir_build_samplers_with_splits,
+    .resize_extended_split = stbir_resize_extended_split,
+    .free_samplers = stbir_free_samplers,
+};
+
+static const ResizeKernels *resize_kernels(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2")) {
+        return &resize_kernels_avx2;
+    }
+#endif
+    return &resize_kernels_default;
+}
+
+static const int resize_channels[] = {
+    [STBIR_1CHANNEL] = 1,
+    [STBIR_2CHANNEL] = 2,
+    [STBIR_RGB] = 3,
+    [STBIR_BGR] = 3,
+    [STBIR_4CHANNEL] = 4,
+    [STBIR_RGBA] = 4,
+    [STBIR_BGRA] = 4,
+    [STBIR_ARGB] = 4,
+    [STBIR_ABGR] = 4,
+    [STBIR_RA] = 2,
+    [STBIR_AR] = 2,
+};
+
+typedef struct {
+    const ResizeKernels *kernels;
+    STBIR_RESIZE        *resize;
+    atomic_bool          failed;
+} ResizeSplits;
+
+static void resize_split(void *data, size_t index) {
+    ResizeSplits *s = data;
+    if (!s->kernels->resize_extended_split(s->resize, index, 1)) {
+        atomic_store(&s->failed, true);
+    }
+}
+
+bool resize(Pool *pool, const ResizeImage *input, const ResizeImage *output) {
+    const ResizeKernels *kernels = resize_kernels();
+
+    STBIR_RESIZE r;
+    kernels->init(
+        &r,
+        input->pixels,
+        input->width,
+        input->height,
+        input->stride,
+        output->pixels,
+        output->width,
+        output->height,
+        output->stride,
+        input->layout,
+        STBIR_TYPE_UINT8);
+
+    if (input->layout != output->layout &&
+        !kernels->set_pixel_layouts(&r, input->layout, output->layout)) {
+        return false;
+    }
+
+    // Asks for a few more bands than there are threads, so uneven ones even out
+    const int threads = pool ? pool->count + 1 : 1;
+    const int splits = kernels->build_samplers_with_splits(&r, threads > 1 ? threads * 4 : 1);
+    if (!splits) {
+        return false;
+    }
+
+    ResizeSplits s = {.kernels = kernels, .resize = &r};
+    if (pool) {
+        pool_for(pool, resize_split, &s, splits);
+    } else {
+        resize_split(&s, 0);
+    }
+
+    kernels->free_samplers(&r);
+    return !atomic_load(&s.failed);
+}
+
+uint8_t *resize_alloc(
+    Pool              *pool,
+    const uint8_t     *pixels,
+    size_t             width,
+    size_t             height,
+    size_t             out_width,
+    size_t             out_height,
+    stbir_pixel_layout layout) {
+    uint8_t *output = malloc(out_width * out_height * resize_channels[layout]);
+    if (!output) {
+        return NULL;
+    }
+
+    const ResizeImage in = {(void *) pixels, width, height, 0, layout};
+    const ResizeImage out = {output, out_width, out_height, 0, layout};
+    if (!resize(pool, &in, &out)) {
+        free(output);
+        return NULL;
+    }
+
+    return output;
+}
@@ -0,0 +1,58 @@
+#ifndef RESIZE_H
+#define RESIZE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pool.h"
+#include "stb_image_resize2.h"
+
+typedef struct {
+    void              *pixels; // Only read from on the input side
+    size_t             width;
+    size_t             height;
+    size_t             stride; // In bytes, zero if the rows are tightly packed
+    stbir_pixel_layout layout;
+} ResizeImage;
+
+// Resizes 8 bit pixels with the kernels of the widest instruction set the CPU supports. The output
+// is split into bands across the pool and the calling thread, or resized on the calling thread
+// alone if the pool is NULL. The layouts may differ as long as their channel counts match
+bool resize(Pool *pool, const ResizeImage *input, const ResizeImage *output);
+
+// Resizes tightly packed pixels into a new allocation, NULL if out of memory
+uint8_t *resize_alloc(
+    Pool              *pool,
+    const uint8_t     *pixels,
+    size_t             width,
+    size_t             height,
+    size_t             out_width,
+    size_t             out_height,
+    stbir_pixel_layout layout);
+
+// The resizer compiled for a particular instruction set
+typedef struct {
+    void (*init)(
+        STBIR_RESIZE      *resize,
+        const void        *input,
+        int                input_w,
+        int                input_h,
+        int                input_stride,
+        void              *output,
+        int                output_w,
+        int                output_h,
+        int                output_stride,
+        stbir_pixel_layout layout,
+        stbir_datatype     type);
+    int (*set_pixel_layouts)(STBIR_RESIZE *resize, stbir_pixel_layout in, stbir_pixel_layout out);
+    int (*build_samplers_with_splits)(STBIR_RESIZE *resize, int splits);
+    int (*resize_extended_split)(STBIR_RESIZE *resize, int start, int count);
+    void (*free_samplers)(STBIR_RESIZE *resize);
+} ResizeKernels;
+
+#if defined(__x86_64__) || defined(__i386__)
+extern const ResizeKernels resize_kernels_avx2;
+#endif
+
+#endif // RESIZE_H
@@ -0,0 +1,23 @@
+#if defined(__x86_64__) || defined(__i386__)
+
+// A private copy of the resizer built with its AVX2 kernels, which resize() only picks if the CPU
+// supports them, so the rest of the program still runs anywhere
+#pragma GCC target("avx2")
+#pragma GCC diagnostic ignored "-Wunused-function"
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#define STB_IMAGE_RESIZE_STATIC
+#define STBIR_AVX2
+#include "stb_image_resize2.h"
+#undef STB_IMAGE_RESIZE_IMPLEMENTATION
+
+#include "resize.h"
+
+const ResizeKernels resize_kernels_avx2 = {
+    .init = stbir_resize_init,
+    .set_pixel_layouts = stbir_set_pixel_layouts,
+    .build_samplers_with_splits = stbir_build_samplers_with_splits,
+    .resize_extended_split = stbir_resize_extended_split,
+    .free_samplers = stbir_free_samplers,
+};
+
+#endif
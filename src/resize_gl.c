@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "resize_gl.h"
+#include "shader.h"
+
+static bool resize_gl_format(stbir_pixel_layout layout, GLenum *format, GLenum *type) {
+    switch (layout) {
+    case STBIR_RGBA:
+        *format = GL_RGBA;
+        *type = GL_UNSIGNED_BYTE;
+        return true;
+
+    case STBIR_BGRA:
+        *format = GL_BGRA;
+        *type = GL_UNSIGNED_BYTE;
+        return true;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // The packed types store the first component in the most significant byte
+    case STBIR_ARGB:
+        *format = GL_BGRA;
+        *type = GL_UNSIGNED_INT_8_8_8_8;
+        return true;
+
+    case STBIR_ABGR:
+        *format = GL_RGBA;
+        *type = GL_UNSIGNED_INT_8_8_8_8;
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+static void resize_gl_texture(GLuint texture, size_t width, size_t height, const void *pixels) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(
+        GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+// Resizes the region of the texture along one axis into the target, which is attached to the
+// framebuffer and must already have the size of the pass
+static void resize_gl_pass(
+    ResizeGl   *r,
+    GLuint      from,
+    GLuint      to,
+    int         axis,
+    const GLint region[4],
+    size_t      width,
+    size_t      height) {
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, to, 0);
+    glViewport(0, 0, width, height);
+
+    glBindTexture(GL_TEXTURE_2D, from);
+    glUniform2i(r->uniform_axis, axis == 0, axis == 1);
+    glUniform4iv(r->uniform_region, 1, region);
+    glUniform1f(r->uniform_scale, (float) region[2 + axis] / (axis ? height : width));
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+bool resize_gl_init(ResizeGl *r, Display *display) {
+    memset(r, 0, sizeof(*r));
+
+    const char *renderer = getenv(RENDERER_ENV);
+    const bool  force_cpu = renderer && !strcmp(renderer, "cpu");
+    const bool  force_gl = renderer && !strcmp(renderer, "gl");
+
+    int error_base, event_base;
+    if (force_cpu || !glXQueryExtension(display, &error_base, &event_base)) {
+        return false;
+    }
+
+    const int attribs[] = {
+        GLX_DRAWABLE_TYPE,
+        GLX_PBUFFER_BIT,
+        GLX_RENDER_TYPE,
+        GLX_RGBA_BIT,
+        None,
+    };
+
+    int          count = 0;
+    GLXFBConfig *configs = glXChooseFBConfig(display, DefaultScreen(display), attribs, &count);
+    if (!configs || !count) {
+        if (configs) XFree(configs);
+        return false;
+    }
+
+    // Everything is drawn into framebuffers of its own, the pbuffer is only there to be current
+    const int pbuffer_attribs[] = {GLX_PBUFFER_WIDTH, 1, GLX_PBUFFER_HEIGHT, 1, None};
+    r->display = display;
+    r->pbuffer = glXCreatePbuffer(display, configs[0], pbuffer_attribs);
+    r->context = glXCreateNewContext(display, configs[0], GLX_RGBA_TYPE, NULL, True);
+    XFree(configs);
+
+    if (!r->pbuffer || !r->context ||
+        !glXMakeContextCurrent(display, r->pbuffer, r->pbuffer, r->context)) {
+        resize_gl_free(r);
+        return false;
+    }
+
+    // The shaders need at least OpenGL 3.3, and older contexts do not even know the version query
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major * 10 + minor < 33 || (!force_gl && gl_is_software())) {
+        resize_gl_free(r);
+        return false;
+    }
+
+    r->program = compile_program(resize_vs, resize_fs);
+    r->uniform_axis = get_uniform(r->program, "axis");
+    r->uniform_region = get_uniform(r->program, "region");
+    r->uniform_scale = get_uniform(r->program, "scale");
+    glUseProgram(r->program);
+
+    glGenVertexArrays(1, &r->vao);
+    glBindVertexArray(r->vao);
+
+    glGenFramebuffers(1, &r->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, r->fbo);
+
+    glGenTextures(1, &r->image);
+    glGenTextures(1, &r->scratch);
+    glGenTextures(1, &r->target);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &r->max_size);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    return true;
+}
+
+void resize_gl_free(ResizeGl *r) {
+    if (r->context && glXGetCurrentContext() == r->context) {
+        for (size_t i = 0; i < r->pending.count; i++) {
+            glDeleteBuffers(1, &r->pending.data[i].buffer);
+        }
+
+        glDeleteTextures(1, &r->image);
+        glDeleteTextures(1, &r->scratch);
+        glDeleteTextures(1, &r->target);
+        glDeleteFramebuffers(1, &r->fbo);
+        glDeleteVertexArrays(1, &r->vao);
+        if (r->program) glDeleteProgram(r->program);
+        glXMakeContextCurrent(r->display, None, None, NULL);
+    }
+
+    if (r->context) glXDestroyContext(r->display, r->context);
+    if (r->pbuffer) glXDestroyPbuffer(r->display, r->pbuffer);
+    da_free(&r->pending);
+    memset(r, 0, sizeof(*r));
+}
+
+bool resize_gl_upload(ResizeGl *r, const uint8_t *pixels, size_t width, size_t height) {
+    if (width > (size_t) r->max_size || height > (size_t) r->max_size) {
+        return false;
+    }
+
+    resize_gl_texture(r->image, width, height, pixels);
+    r->width = width;
+    r->height = height;
+    return glGetError() == GL_NO_ERROR;
+}
+
+bool resize_gl_queue(
+    ResizeGl          *r,
+    size_t             x,
+    size_t             y,
+    size_t             width,
+    size_t             height,
+    const ResizeImage *output) {
+    ResizeGlReadback readback = {.output = *output};
+    if (!resize_gl_format(output->layout, &readback.format, &readback.type)) {
+        return false;
+    }
+
+    if (x + width > r->width || y + height > r->height ||
+        output->width > (size_t) r->max_size || output->height > (size_t) r->max_size) {
+        return false;
+    }
+
+    // Separable, so every pixel of the target only filters along one axis at a time
+    const GLint horizontal[] = {x, y, width, height};
+    resize_gl_texture(r->scratch, output->width, height, NULL);
+    resize_gl_pass(r, r->image, r->scratch, 0, horizontal, output->width, height);
+
+    const GLint vertical[] = {0, 0, output->width, height};
+    resize_gl_texture(r->target, output->width, output->height, NULL);
+    resize_gl_pass(r, r->scratch, r->target, 1, vertical, output->width, output->height);
+
+    // Returns right away, the copy into the buffer only has to be done by the time it is mapped
+    const size_t size = output->width * output->height * sizeof(uint32_t);
+    glGenBuffers(1, &readback.buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    glReadPixels(0, 0, output->width, output->height, readback.format, readback.type, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // A failed readback is dropped, as the caller resizes the region on the CPU instead and it
+    // would otherwise be overwritten by whatever the buffer holds once finished
+    if (glGetError() != GL_NO_ERROR) {
+        glDeleteBuffers(1, &readback.buffer);
+        return false;
+    }
+
+    da_append(&r->pending, readback);
+    return true;
+}
+
+bool resize_gl_finish(ResizeGl *r) {
+    bool ok = true;
+    for (size_t i = 0; i < r->pending.count; i++) {
+        const ResizeGlReadback *it = &r->pending.data[i];
+        const ResizeImage      *out = &it->output;
+
+        const size_t row = out->width * sizeof(uint32_t);
+        const size_t stride = out->stride ? out->stride : row;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, it->buffer);
+        const uint8_t *pixels =
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, row * out->height, GL_MAP_READ_BIT);
+        if (pixels) {
+            // Rows are read back bottom up, which is how the image was uploaded in the first place
+            for (size_t y = 0; y < out->height; y++) {
+                memcpy((uint8_t *) out->pixels + y * stride, pixels + y * row, row);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            ok = false;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glDeleteBuffers(1, &it->buffer);
+    }
+
+    r->pending.count = 0;
+    return ok;
+}
@@ -0,0 +1,68 @@
+#ifndef RESIZE_GL_H
+#define RESIZE_GL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "da.h"
+#include "gl.h"
+#include "resize.h"
+
+#include <GL/glx.h>
+
+typedef struct {
+    GLuint      buffer;
+    ResizeImage output;
+    GLenum      format;
+    GLenum      type;
+} ResizeGlReadback;
+
+// Resizes on the GPU in an offscreen context of its own, so it works without any window. The
+// image is uploaded once and can then be resized into any amount of outputs, whose pixels are
+// read back through pixel buffers only once all of them have been queued
+typedef struct {
+    Display    *display;
+    GLXContext  context;
+    GLXPbuffer  pbuffer;
+
+    GLuint program;
+    GLint  uniform_axis;
+    GLint  uniform_region;
+    GLint  uniform_scale;
+
+    GLuint vao;
+    GLuint fbo;
+    GLuint image;
+    GLuint scratch;
+    GLuint target;
+    GLint  max_size;
+
+    size_t width;
+    size_t height;
+
+    DynamicArray(ResizeGlReadback) pending;
+} ResizeGl;
+
+// Returns false if there is no hardware accelerated GL to resize with, in which case the resizer
+// on the CPU should be used instead. Follows the renderer override of the viewer
+bool resize_gl_init(ResizeGl *r, Display *display);
+void resize_gl_free(ResizeGl *r);
+
+// Uploads tightly packed RGBA pixels as the image to resize from
+bool resize_gl_upload(ResizeGl *r, const uint8_t *pixels, size_t width, size_t height);
+
+// Queues resizing the rectangle of the image into the output, which is only written to once
+// resize_gl_finish() returns. Returns false if the output is not supported, without queueing
+bool resize_gl_queue(
+    ResizeGl          *r,
+    size_t             x,
+    size_t             y,
+    size_t             width,
+    size_t             height,
+    const ResizeImage *output);
+
+// Waits for every queued resize and copies the pixels into their outputs
+bool resize_gl_finish(ResizeGl *r);
+
+#endif // RESIZE_GL_H
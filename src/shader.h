@@ -3,10 +3,11 @@
 
 #include <stdbool.h>
 
+extern const char grid_fs[];
+extern const char grid_vs[];
 extern const char image_fs[];
 extern const char image_vs[];
-
-extern const char overlay_fs[];
-extern const char overlay_vs[];
+extern const char resize_fs[];
+extern const char resize_vs[];
 
 #endif // SHADER_H
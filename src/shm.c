@@ -0,0 +1,100 @@
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <X11/Xutil.h>
+
+#include "shm.h"
+
+static bool shm_failed;
+
+static int shm_error_handler(Display *display, XErrorEvent *e) {
+    (void) display;
+    (void) e;
+    shm_failed = true;
+    return 0;
+}
+
+bool shm_attach(Display *display, XShmSegmentInfo *shm, size_t size, bool read_only) {
+    *shm = (XShmSegmentInfo) {0};
+    if (!XShmQueryExtension(display)) {
+        return false;
+    }
+
+    shm->shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (shm->shmid < 0) {
+        return false;
+    }
+
+    bool attached = false;
+    shm->shmaddr = shmat(shm->shmid, NULL, 0);
+    shm->readOnly = read_only;
+    if (shm->shmaddr != (char *) -1) {
+        // Attaching fails asynchronously on remote displays
+        XSync(display, False);
+        shm_failed = false;
+        int (*handler)(Display *, XErrorEvent *) = XSetErrorHandler(shm_error_handler);
+        XShmAttach(display, shm);
+        XSync(display, False);
+        XSetErrorHandler(handler);
+        attached = !shm_failed;
+    }
+
+    // The segment goes away once both sides have detached
+    shmctl(shm->shmid, IPC_RMID, NULL);
+    if (!attached) {
+        if (shm->shmaddr != (char *) -1) shmdt(shm->shmaddr);
+        *shm = (XShmSegmentInfo) {0};
+    }
+
+    return attached;
+}
+
+void shm_detach(Display *display, XShmSegmentInfo *shm) {
+    XShmDetach(display, shm);
+    shmdt(shm->shmaddr);
+    *shm = (XShmSegmentInfo) {0};
+}
+
+typedef struct {
+    unsigned long mask;
+    int           shift;
+    unsigned long max; // Of the channel once shifted down
+} ShmChannel;
+
+static ShmChannel shm_channel(unsigned long mask) {
+    if (!mask) return (ShmChannel) {0, 0, 1};
+    const int shift = __builtin_ctzl(mask);
+    return (ShmChannel) {mask, shift, mask >> shift};
+}
+
+static uint8_t shm_scale(unsigned long pixel, ShmChannel c) {
+    const unsigned long value = (pixel & c.mask) >> c.shift;
+    return c.max == 0xFF ? value : value * 0xFF / c.max;
+}
+
+void shm_unpack(
+    const XImage *image,
+    XRectangle    rect,
+    uint8_t      *pixels,
+    size_t        stride,
+    size_t        channels) {
+    const ShmChannel r = shm_channel(image->red_mask);
+    const ShmChannel g = shm_channel(image->green_mask);
+    const ShmChannel b = shm_channel(image->blue_mask);
+
+    // Practically every visual has 32 bit pixels in host order, which are read directly
+    const int  host = *(const uint8_t *) &(uint16_t) {1} ? LSBFirst : MSBFirst;
+    const bool direct = image->bits_per_pixel == 32 && image->byte_order == host;
+
+    for (int y = rect.y; y < rect.y + rect.height; y++) {
+        const uint32_t *row = (const uint32_t *) (image->data + y * image->bytes_per_line);
+        uint8_t        *it = &pixels[(y - rect.y) * stride * channels];
+        for (int x = rect.x; x < rect.x + rect.width; x++, it += channels) {
+            const unsigned long p = direct ? row[x] : XGetPixel((XImage *) image, x, y);
+            it[0] = shm_scale(p, r);
+            it[1] = shm_scale(p, g);
+            it[2] = shm_scale(p, b);
+            if (channels == 4) it[3] = 0xFF;
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef SHM_H
+#define SHM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
+
+// Creates a shared memory segment and attaches it to both the server and this process. Returns
+// false without MIT-SHM, or if the server cannot attach it, such as on remote displays
+bool shm_attach(Display *display, XShmSegmentInfo *shm, size_t size, bool read_only);
+void shm_detach(Display *display, XShmSegmentInfo *shm);
+
+// Unpacks a rectangle of an image read from the server into 8 bit RGB, or RGBA with opaque alpha
+// with 4 channels, scaling channels of any width. The stride of the rows is in pixels. The pixels
+// may be the data of the image itself, as long as they are written no further ahead than read
+void shm_unpack(
+    const XImage *image,
+    XRectangle    rect,
+    uint8_t      *pixels,
+    size_t        stride,
+    size_t        channels);
+
+#endif // SHM_H
@@ -0,0 +1,117 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+
+#include "worker.h"
+
+static void *worker_thread(void *arg) {
+    Worker *w = arg;
+
+    // On Linux this only affects the calling thread
+    if (w->nice) setpriority(PRIO_PROCESS, 0, w->nice);
+
+    pthread_mutex_lock(&w->mutex);
+    while (true) {
+        while (!w->quit && !w->pending.count) {
+            pthread_cond_wait(&w->wake, &w->mutex);
+        }
+
+        if (w->quit) break;
+        const WorkerJob job = w->pending.data[0];
+        da_remove(&w->pending, 0);
+
+        pthread_mutex_unlock(&w->mutex);
+        job.fn(job.data);
+        pthread_mutex_lock(&w->mutex);
+
+        da_append(&w->done, job.data);
+
+        const uint64_t one = 1;
+        write(w->event, &one, sizeof(one));
+    }
+    pthread_mutex_unlock(&w->mutex);
+
+    return NULL;
+}
+
+void worker_init(Worker *w, size_t count) {
+    if (!count) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count = online > 0 ? online : 1;
+    }
+
+    w->event = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (w->event < 0) {
+        fprintf(stderr, "ERROR: Could not create eventfd\n");
+        exit(1);
+    }
+
+    w->count = count;
+    w->threads = malloc(count * sizeof(*w->threads));
+    if (!w->threads) {
+        fprintf(stderr, "ERROR: Could not allocate worker threads\n");
+        exit(1);
+    }
+
+    pthread_mutex_init(&w->mutex, NULL);
+    pthread_cond_init(&w->wake, NULL);
+
+    for (size_t i = 0; i < count; i++) {
+        if (pthread_create(&w->threads[i], NULL, worker_thread, w)) {
+            fprintf(stderr, "ERROR: Could not create worker thread\n");
+            exit(1);
+        }
+    }
+}
+
+void worker_free(Worker *w, WorkerFn discard) {
+    pthread_mutex_lock(&w->mutex);
+    w->quit = true;
+    pthread_cond_broadcast(&w->wake);
+    pthread_mutex_unlock(&w->mutex);
+
+    for (size_t i = 0; i < w->count; i++) {
+        pthread_join(w->threads[i], NULL);
+    }
+
+    for (size_t i = 0; i < w->pending.count; i++) {
+        discard(w->pending.data[i].data);
+    }
+
+    for (size_t i = 0; i < w->done.count; i++) {
+        discard(w->done.data[i]);
+    }
+
+    da_free(&w->pending);
+    da_free(&w->done);
+    pthread_cond_destroy(&w->wake);
+    pthread_mutex_destroy(&w->mutex);
+    free(w->threads);
+    close(w->event);
+}
+
+void worker_push(Worker *w, WorkerFn fn, void *data) {
+    pthread_mutex_lock(&w->mutex);
+    da_append(&w->pending, ((WorkerJob) {.fn = fn, .data = data}));
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->mutex);
+}
+
+void *worker_pop(Worker *w) {
+    void *result = NULL;
+
+    pthread_mutex_lock(&w->mutex);
+    if (w->done.count) {
+        result = w->done.data[0];
+        da_remove(&w->done, 0);
+    } else {
+        uint64_t count;
+        read(w->event, &count, sizeof(count));
+    }
+    pthread_mutex_unlock(&w->mutex);
+
+    return result;
+}
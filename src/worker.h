@@ -0,0 +1,43 @@
+#ifndef WORKER_H
+#define WORKER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "da.h"
+
+typedef void (*WorkerFn)(void *data);
+
+typedef struct {
+    WorkerFn fn;
+    void    *data;
+} WorkerJob;
+
+// Background threads running jobs off the render thread. Finished jobs are handed back through
+// worker_pop(), and the eventfd becomes readable whenever there are any
+typedef struct {
+    pthread_t *threads;
+    size_t     count;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t  wake;
+
+    DynamicArray(WorkerJob) pending;
+    DynamicArray(void *) done;
+
+    int  event;
+    bool quit;
+    int  nice; // Of the threads, as the priority of a single thread is lowered from within it
+} Worker;
+
+// A count of zero uses one thread per online CPU. The nice value is set beforehand, if any
+void worker_init(Worker *w, size_t count);
+
+// Finished jobs, as well as the ones which never got to run, are passed to discard
+void worker_free(Worker *w, WorkerFn discard);
+
+void  worker_push(Worker *w, WorkerFn fn, void *data);
+void *worker_pop(Worker *w);
+
+#endif // WORKER_H